@@ -182,12 +182,13 @@ status() {
 
 # Usage: ./run.sh build
 # Build the ledger-app-hive repository inside the container
+# HIVE_OPS=transfer,withdraw_vesting ./run.sh build 1.6 only compiles in the listed operations
 build() {
   msg green "Building ledger-app-hive inside container ..."
   if container_running; then
     case $1 in
       1.[4-6])
-        docker exec ledger-app-hive bash -cl "/ledger-app-hive/build-hive.sh $1" &&
+        docker exec -e HIVE_OPS="$HIVE_OPS" ledger-app-hive bash -cl "/ledger-app-hive/build-hive.sh $1" &&
         msg bold "Copying ledger-app-hive application to host..." &&
         docker cp ledger-app-hive:/ledger-app-hive/bin/app.hex $DIR/bin/app-$1.hex &&
         docker cp ledger-app-hive:/ledger-app-hive/debug/app.map $DIR/debug/app-$1.map &&
@@ -0,0 +1,258 @@
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "hive_address_book.h"
+#include "os.h"
+#include <string.h>
+
+// entries rewritten by a single nvm_write
+#define ADDRESS_BOOK_CHUNK 4
+
+const addressBook_t N_addressBook_real;
+#define N_addressBook (*(volatile addressBook_t *)PIC(&N_addressBook_real))
+
+typedef struct addressBookChunk_t {
+    uint8_t names[ADDRESS_BOOK_CHUNK][ADDRESS_BOOK_NAME_LENGTH];
+    uint8_t count;
+    uint8_t first;
+} addressBookChunk_t;
+
+static int compareNames(const uint8_t *a, const uint8_t *b) {
+    return memcmp(a, b, ADDRESS_BOOK_NAME_LENGTH);
+}
+
+static const uint8_t *storedName(uint8_t index) {
+    return (const uint8_t *)N_addressBook.names[index];
+}
+
+static bool isAccountCharacter(uint8_t c) {
+    return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '.' || c == '-';
+}
+
+static void writeCount(uint8_t count) {
+    nvm_write((void *)&N_addressBook.count, &count, sizeof(count));
+}
+
+static void flushChunk(addressBookChunk_t *chunk) {
+    if (chunk->count != 0) {
+        nvm_write((void *)N_addressBook.names[chunk->first], chunk->names,
+                  chunk->count * ADDRESS_BOOK_NAME_LENGTH);
+        chunk->count = 0;
+    }
+}
+
+void hive_address_book_init(void) {
+    writeCount(0);
+}
+
+/**
+ * Account names, each prefixed with its length. Returns the number of
+ * bytes read, parsing stops at the first invalid name.
+*/
+uint32_t hive_address_book_parse(addressBookBatch_t *batch, uint8_t *buffer, uint32_t length) {
+    uint8_t name[ADDRESS_BOOK_NAME_LENGTH];
+    uint32_t offset = 0;
+    uint8_t nameLength;
+    uint8_t i;
+
+    os_memset(batch, 0, sizeof(addressBookBatch_t));
+    while (offset < length) {
+        nameLength = buffer[offset];
+        if ((nameLength < 3) || (nameLength > ADDRESS_BOOK_NAME_LENGTH) ||
+            (offset + 1 + nameLength > length) || (batch->count == ADDRESS_BOOK_BATCH)) {
+            break;
+        }
+        os_memset(name, 0, sizeof(name));
+        for (i = 0; i < nameLength; ++i) {
+            if (!isAccountCharacter(buffer[offset + 1 + i])) {
+                return offset;
+            }
+            name[i] = buffer[offset + 1 + i];
+        }
+        offset += 1 + nameLength;
+
+        // insertion keeps the batch sorted, duplicates are dropped
+        i = batch->count;
+        while (i > 0 && compareNames(batch->names[i - 1], name) > 0) {
+            i--;
+        }
+        if (i > 0 && compareNames(batch->names[i - 1], name) == 0) {
+            continue;
+        }
+        os_memmove(batch->names[i + 1], batch->names[i], (batch->count - i) * ADDRESS_BOOK_NAME_LENGTH);
+        os_memmove(batch->names[i], name, ADDRESS_BOOK_NAME_LENGTH);
+        batch->count++;
+    }
+    return offset;
+}
+
+static bool findName(const uint8_t *name) {
+    uint8_t low = 0;
+    uint8_t high = N_addressBook.count;
+
+    while (low < high) {
+        uint8_t middle = (low + high) / 2;
+        int order = compareNames(storedName(middle), name);
+
+        if (order == 0) {
+            return true;
+        }
+        if (order < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return false;
+}
+
+/**
+ * Keep only the names that are not trusted yet.
+*/
+void hive_address_book_drop_known(addressBookBatch_t *batch) {
+    uint8_t kept = 0;
+    uint8_t i;
+
+    for (i = 0; i < batch->count; ++i) {
+        if (!findName(batch->names[i])) {
+            os_memmove(batch->names[kept++], batch->names[i], ADDRESS_BOOK_NAME_LENGTH);
+        }
+    }
+    batch->count = kept;
+}
+
+uint8_t hive_address_book_count(void) {
+    return N_addressBook.count;
+}
+
+/**
+ * Merge a batch of new names, from the end of the table backwards so that
+ * entries are only moved once and every chunk of them is written with a
+ * single nvm_write. Entries before the first new name are left untouched.
+ * The count is written last.
+*/
+bool hive_address_book_add(addressBookBatch_t *batch) {
+    addressBookChunk_t chunk;
+    uint8_t count = N_addressBook.count;
+    int16_t stored = (int16_t)count - 1;
+    int16_t added = (int16_t)batch->count - 1;
+    int16_t position = (int16_t)count + batch->count - 1;
+    const uint8_t *name;
+
+    if (count + batch->count > ADDRESS_BOOK_SIZE) {
+        return false;
+    }
+    chunk.count = 0;
+    while (added >= 0) {
+        if (stored >= 0 && compareNames(storedName(stored), batch->names[added]) > 0) {
+            name = storedName(stored--);
+        } else {
+            name = batch->names[added--];
+        }
+        // the chunk fills from its end, it ends up starting at the position
+        os_memmove(chunk.names[ADDRESS_BOOK_CHUNK - 1 - chunk.count], name, ADDRESS_BOOK_NAME_LENGTH);
+        chunk.count++;
+        chunk.first = position--;
+        if (chunk.count == ADDRESS_BOOK_CHUNK || added < 0) {
+            nvm_write((void *)N_addressBook.names[chunk.first],
+                      chunk.names[ADDRESS_BOOK_CHUNK - chunk.count],
+                      chunk.count * ADDRESS_BOOK_NAME_LENGTH);
+            chunk.count = 0;
+        }
+    }
+    writeCount(count + batch->count);
+    return true;
+}
+
+/**
+ * Drop the names of a batch, names that are not trusted are ignored.
+ * The entries following the first removed one move down, a chunk at a
+ * time.
+*/
+void hive_address_book_remove(addressBookBatch_t *batch) {
+    addressBookChunk_t chunk;
+    uint8_t count = N_addressBook.count;
+    uint8_t kept = 0;
+    uint8_t removed = 0;
+    uint8_t stored;
+    int order = 1;
+
+    chunk.count = 0;
+    for (stored = 0; stored < count; ++stored) {
+        while (removed < batch->count &&
+               (order = compareNames(batch->names[removed], storedName(stored))) < 0) {
+            removed++;
+        }
+        if (removed < batch->count && order == 0) {
+            continue;
+        }
+        if (kept != stored) {
+            if (chunk.count == 0) {
+                chunk.first = kept;
+            }
+            os_memmove(chunk.names[chunk.count++], storedName(stored), ADDRESS_BOOK_NAME_LENGTH);
+            if (chunk.count == ADDRESS_BOOK_CHUNK) {
+                flushChunk(&chunk);
+            }
+        }
+        kept++;
+    }
+    flushChunk(&chunk);
+    if (kept != count) {
+        writeCount(kept);
+    }
+}
+
+void hive_address_book_clear(void) {
+    writeCount(0);
+}
+
+bool hive_address_book_contains(const char *name, uint32_t length) {
+    uint8_t padded[ADDRESS_BOOK_NAME_LENGTH];
+
+    if (length == 0 || length > ADDRESS_BOOK_NAME_LENGTH) {
+        return false;
+    }
+    os_memset(padded, 0, sizeof(padded));
+    os_memmove(padded, name, length);
+    return findName(padded);
+}
+
+/**
+ * Names from index first, each prefixed with its length, as many as fit.
+ * Returns the number of bytes written.
+*/
+uint32_t hive_address_book_list(uint8_t first, uint8_t *out, uint32_t size) {
+    uint32_t offset = 0;
+    uint8_t nameLength;
+
+    for (; first < N_addressBook.count; ++first) {
+        const uint8_t *name = storedName(first);
+
+        nameLength = 0;
+        while (nameLength < ADDRESS_BOOK_NAME_LENGTH && name[nameLength] != 0) {
+            nameLength++;
+        }
+        if (offset + 1 + nameLength > size) {
+            break;
+        }
+        out[offset++] = nameLength;
+        os_memmove(out + offset, name, nameLength);
+        offset += nameLength;
+    }
+    return offset;
+}
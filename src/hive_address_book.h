@@ -0,0 +1,63 @@
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __HIVE_ADDRESS_BOOK_H__
+#define __HIVE_ADDRESS_BOOK_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ADDRESS_BOOK_SIZE 64
+// account names are at most 16 characters, stored zero padded
+#define ADDRESS_BOOK_NAME_LENGTH 16
+
+// names added or removed by a single command
+#if defined(TARGET_NANOX)
+#define ADDRESS_BOOK_BATCH 8
+#else
+#define ADDRESS_BOOK_BATCH 4
+#endif
+
+/**
+ * Trusted recipients, kept in NVM sorted by name so that a review looks
+ * a recipient up with a binary search. Names are compared zero padded,
+ * which orders them as strings.
+*/
+typedef struct addressBook_t {
+    uint8_t count;
+    uint8_t names[ADDRESS_BOOK_SIZE][ADDRESS_BOOK_NAME_LENGTH];
+} addressBook_t;
+
+/**
+ * Names of a command, sorted and without duplicates.
+*/
+typedef struct addressBookBatch_t {
+    uint8_t count;
+    uint8_t names[ADDRESS_BOOK_BATCH][ADDRESS_BOOK_NAME_LENGTH];
+} addressBookBatch_t;
+
+void hive_address_book_init(void);
+uint32_t hive_address_book_parse(addressBookBatch_t *batch, uint8_t *buffer, uint32_t length);
+void hive_address_book_drop_known(addressBookBatch_t *batch);
+uint8_t hive_address_book_count(void);
+bool hive_address_book_add(addressBookBatch_t *batch);
+void hive_address_book_remove(addressBookBatch_t *batch);
+void hive_address_book_clear(void);
+bool hive_address_book_contains(const char *name, uint32_t length);
+uint32_t hive_address_book_list(uint8_t first, uint8_t *out, uint32_t size);
+
+#endif // __HIVE_ADDRESS_BOOK_H__
@@ -0,0 +1,112 @@
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __HIVE_CURSOR_H__
+#define __HIVE_CURSOR_H__
+
+#include "os.h"
+#include <stdint.h>
+#include "hive_types.h"
+
+/**
+ * Read position over a serialized buffer. Every primitive checks the
+ * remaining length once and throws on overrun, so decoders never
+ * read past the end of the data they were given.
+ * Integers are little endian, as serialized by Hive.
+*/
+typedef struct cursor_t {
+    uint8_t *ptr;
+    uint32_t remaining;
+} cursor_t;
+
+static inline void cursor_init(cursor_t *cursor, uint8_t *buffer, uint32_t length) {
+    cursor->ptr = buffer;
+    cursor->remaining = length;
+}
+
+static inline uint32_t cursor_remaining(const cursor_t *cursor) {
+    return cursor->remaining;
+}
+
+/**
+ * Return a pointer to the next length bytes and move past them.
+*/
+static inline uint8_t *cursor_read_bytes(cursor_t *cursor, uint32_t length) {
+    if (length > cursor->remaining) {
+        PRINTF("cursor Insufficient buffer\n");
+        THROW(EXCEPTION);
+    }
+    uint8_t *data = cursor->ptr;
+    cursor->ptr += length;
+    cursor->remaining -= length;
+    return data;
+}
+
+static inline void cursor_skip(cursor_t *cursor, uint32_t length) {
+    cursor_read_bytes(cursor, length);
+}
+
+static inline uint8_t cursor_read_u8(cursor_t *cursor) {
+    return *cursor_read_bytes(cursor, 1);
+}
+
+static inline uint16_t cursor_read_u16(cursor_t *cursor) {
+    uint8_t *p = cursor_read_bytes(cursor, 2);
+    return (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+}
+
+static inline uint32_t cursor_read_u32(cursor_t *cursor) {
+    uint8_t *p = cursor_read_bytes(cursor, 4);
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint64_t cursor_read_u64(cursor_t *cursor) {
+    uint8_t *p = cursor_read_bytes(cursor, 8);
+    uint64_t value = 0;
+    for (int8_t i = 7; i >= 0; i--) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+/**
+ * fc::unsigned_int, at most 5 bytes for a 32 bits value.
+*/
+static inline variant32_t cursor_read_varint(cursor_t *cursor) {
+    uint32_t value = 0;
+    uint8_t shift = 0;
+    uint8_t b;
+    do {
+        if (shift > 28) {
+            PRINTF("cursor Invalid varint\n");
+            THROW(EXCEPTION);
+        }
+        b = cursor_read_u8(cursor);
+        value |= (uint32_t)(b & 0x7f) << shift;
+        shift += 7;
+    } while (b & 0x80);
+    return value;
+}
+
+static inline void cursor_read_asset(cursor_t *cursor, asset_t *asset) {
+    asset->amount = (int64_t)cursor_read_u64(cursor);
+    asset->precision = cursor_read_u8(cursor);
+    os_memmove(asset->symbol, cursor_read_bytes(cursor, sizeof(asset->symbol)), sizeof(asset->symbol));
+}
+
+#endif // __HIVE_CURSOR_H__
@@ -0,0 +1,111 @@
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "hive_custom_json.h"
+#include "os.h"
+#include <string.h>
+
+#define FIELDS(fields) {fields, sizeof(fields) / sizeof(fields[0])}
+
+// ["follow", {...}] and ["reblog", {...}]
+static const jsonField_t followFields[] = {
+    {"follower", "Follower"},
+    {"following", "Following"},
+    {"what", "Type"},
+    {"account", "Account"},
+    {"author", "Author"},
+    {"permlink", "Permlink"}
+};
+
+// ["delegate_rc", {...}]
+static const jsonField_t rcFields[] = {
+    {"from", "From"},
+    {"delegatees", "Delegatee"},
+    {"max_rc", "Max RC"}
+};
+
+// ["setLastRead", {...}]
+static const jsonField_t notifyFields[] = {
+    {"date", "Date"}
+};
+
+// Hive Engine contract call
+static const jsonField_t hiveEngineFields[] = {
+    {"contractName", "Contract"},
+    {"contractAction", "Action"},
+    {"symbol", "Token"},
+    {"from", "From"},
+    {"to", "To"},
+    {"quantity", "Quantity"},
+    {"price", "Price"},
+    {"memo", "Memo"}
+};
+
+// Splinterlands token transfer
+static const jsonField_t smTokenTransferFields[] = {
+    {"to", "To"},
+    {"qty", "Quantity"},
+    {"token", "Token"},
+    {"type", "Type"},
+    {"app", "App"}
+};
+
+/**
+ * Ordered by id length, then id, for the lookup.
+*/
+static const customJsonId_t customJsonIds[] = {
+    {"rc", "Resource credits", FIELDS(rcFields)},
+    {"follow", "Follow", FIELDS(followFields)},
+    {"notify", "Notifications", FIELDS(notifyFields)},
+    {"reblog", "Reblog", FIELDS(followFields)},
+    {"ssc-mainnet-hive", "Hive Engine", FIELDS(hiveEngineFields)},
+    {"sm_token_transfer", "Splinterlands", FIELDS(smTokenTransferFields)}
+};
+
+static int compareId(const customJsonId_t *entry, const uint8_t *id, uint32_t length) {
+    const char *entryId = (const char *)PIC(entry->id);
+    uint32_t entryLength = strlen(entryId);
+
+    if (entryLength != length) {
+        return entryLength < length ? -1 : 1;
+    }
+    return memcmp(entryId, id, length);
+}
+
+/**
+ * Binary search of the id. Lengths are compared first, so most entries
+ * are passed over without reading their id.
+*/
+const customJsonId_t *hive_custom_json_find(const uint8_t *id, uint32_t length) {
+    uint8_t low = 0;
+    uint8_t high = sizeof(customJsonIds) / sizeof(customJsonIds[0]);
+
+    while (low < high) {
+        uint8_t middle = (low + high) / 2;
+        int order = compareId(&customJsonIds[middle], id, length);
+
+        if (order == 0) {
+            return &customJsonIds[middle];
+        }
+        if (order < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return NULL;
+}
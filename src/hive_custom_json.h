@@ -0,0 +1,35 @@
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __HIVE_CUSTOM_JSON_H__
+#define __HIVE_CUSTOM_JSON_H__
+
+#include <stdint.h>
+#include "hive_json.h"
+
+/**
+ * A custom_json id reviewed with the labels of its payload layout.
+*/
+typedef struct customJsonId_t {
+    const char *id;
+    const char *name;
+    jsonLayout_t layout;
+} customJsonId_t;
+
+const customJsonId_t *hive_custom_json_find(const uint8_t *id, uint32_t length);
+
+#endif // __HIVE_CUSTOM_JSON_H__
@@ -0,0 +1,337 @@
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "hive_json.h"
+#include "os.h"
+#include <string.h>
+
+static bool isJsonSpace(uint8_t c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static void skipSpaces(jsonTokenizer_t *tokenizer) {
+    while (cursor_remaining(&tokenizer->cursor) != 0 && isJsonSpace(*tokenizer->cursor.ptr)) {
+        cursor_skip(&tokenizer->cursor, 1);
+    }
+}
+
+/**
+ * Next significant character, left unread.
+*/
+static uint8_t peekToken(jsonTokenizer_t *tokenizer) {
+    skipSpaces(tokenizer);
+    if (cursor_remaining(&tokenizer->cursor) == 0) {
+        PRINTF("json Unexpected end\n");
+        THROW(EXCEPTION);
+    }
+    return *tokenizer->cursor.ptr;
+}
+
+static bool isHexDigit(uint8_t c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+static uint8_t hexDigitValue(uint8_t c) {
+    if (c <= '9') {
+        return c - '0';
+    }
+    return (c | 0x20) - 'a' + 10;
+}
+
+/**
+ * String body, the opening quote being read. Escapes are checked and
+ * kept as they are.
+*/
+static void readString(jsonTokenizer_t *tokenizer, const uint8_t **data, uint32_t *length) {
+    uint8_t c;
+    uint8_t i;
+
+    *data = tokenizer->cursor.ptr;
+    while ((c = cursor_read_u8(&tokenizer->cursor)) != '"') {
+        if (c < 0x20) {
+            PRINTF("json Invalid string\n");
+            THROW(EXCEPTION);
+        }
+        if (c != '\\') {
+            continue;
+        }
+        c = cursor_read_u8(&tokenizer->cursor);
+        if (c == 'u') {
+            for (i = 0; i < 4; ++i) {
+                if (!isHexDigit(cursor_read_u8(&tokenizer->cursor))) {
+                    PRINTF("json Invalid escape\n");
+                    THROW(EXCEPTION);
+                }
+            }
+        } else if (c == 0 || strchr("\"\\/bfnrt", c) == NULL) {
+            PRINTF("json Invalid escape\n");
+            THROW(EXCEPTION);
+        }
+    }
+    *length = tokenizer->cursor.ptr - *data - 1;
+}
+
+static uint32_t skipDigits(const uint8_t *data, uint32_t length, uint32_t offset) {
+    while (offset < length && data[offset] >= '0' && data[offset] <= '9') {
+        offset++;
+    }
+    return offset;
+}
+
+static bool isNumber(const uint8_t *data, uint32_t length) {
+    uint32_t offset = 0;
+    uint32_t digits;
+
+    if (offset < length && data[offset] == '-') {
+        offset++;
+    }
+    digits = skipDigits(data, length, offset);
+    if (digits == offset) {
+        return false;
+    }
+    offset = digits;
+    if (offset < length && data[offset] == '.') {
+        digits = skipDigits(data, length, ++offset);
+        if (digits == offset) {
+            return false;
+        }
+        offset = digits;
+    }
+    if (offset < length && (data[offset] == 'e' || data[offset] == 'E')) {
+        offset++;
+        if (offset < length && (data[offset] == '+' || data[offset] == '-')) {
+            offset++;
+        }
+        digits = skipDigits(data, length, offset);
+        if (digits == offset) {
+            return false;
+        }
+        offset = digits;
+    }
+    return offset == length;
+}
+
+static bool isLiteral(const uint8_t *data, uint32_t length, const char *literal) {
+    return length == strlen(literal) && memcmp(data, literal, length) == 0;
+}
+
+/**
+ * Number, true, false or null.
+*/
+static void readLiteral(jsonTokenizer_t *tokenizer, const uint8_t **data, uint32_t *length) {
+    uint8_t c;
+
+    *data = tokenizer->cursor.ptr;
+    while (cursor_remaining(&tokenizer->cursor) != 0) {
+        c = *tokenizer->cursor.ptr;
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') ||
+              c == '-' || c == '+' || c == '.' || c == 'E')) {
+            break;
+        }
+        cursor_skip(&tokenizer->cursor, 1);
+    }
+    *length = tokenizer->cursor.ptr - *data;
+    if (!isNumber(*data, *length) && !isLiteral(*data, *length, "true") &&
+        !isLiteral(*data, *length, "false") && !isLiteral(*data, *length, "null")) {
+        PRINTF("json Invalid value\n");
+        THROW(EXCEPTION);
+    }
+}
+
+static void endValue(jsonTokenizer_t *tokenizer) {
+    tokenizer->expect = tokenizer->depth == 0 ? JSON_EXPECT_DONE : JSON_EXPECT_NEXT;
+}
+
+static void closeLevel(jsonTokenizer_t *tokenizer) {
+    cursor_skip(&tokenizer->cursor, 1);
+    tokenizer->depth--;
+    endValue(tokenizer);
+}
+
+void json_init(jsonTokenizer_t *tokenizer, uint8_t *data, uint32_t length) {
+    os_memset(tokenizer, 0, sizeof(jsonTokenizer_t));
+    cursor_init(&tokenizer->cursor, data, length);
+    tokenizer->expect = JSON_EXPECT_VALUE;
+}
+
+/**
+ * Read up to the next scalar value, or empty object or array.
+ * Returns false once the document is complete.
+*/
+bool json_next_value(jsonTokenizer_t *tokenizer, jsonValue_t *value) {
+    for (;;) {
+        jsonLevel_t *level = tokenizer->depth == 0 ? NULL : &tokenizer->levels[tokenizer->depth - 1];
+        uint8_t c;
+
+        if (tokenizer->expect == JSON_EXPECT_DONE) {
+            skipSpaces(tokenizer);
+            if (cursor_remaining(&tokenizer->cursor) != 0) {
+                PRINTF("json Trailing data\n");
+                THROW(EXCEPTION);
+            }
+            return false;
+        }
+
+        c = peekToken(tokenizer);
+        switch (tokenizer->expect) {
+        case JSON_EXPECT_KEY: {
+            const uint8_t *name;
+            uint32_t nameLength;
+
+            if (c != '"') {
+                PRINTF("json Key expected\n");
+                THROW(EXCEPTION);
+            }
+            cursor_skip(&tokenizer->cursor, 1);
+            readString(tokenizer, &name, &nameLength);
+            level->name = name;
+            level->nameLength = nameLength > 0xFF ? 0xFF : nameLength;
+            if (peekToken(tokenizer) != ':') {
+                PRINTF("json Colon expected\n");
+                THROW(EXCEPTION);
+            }
+            cursor_skip(&tokenizer->cursor, 1);
+            tokenizer->expect = JSON_EXPECT_VALUE;
+            break;
+        }
+        case JSON_EXPECT_VALUE:
+            os_memset(value, 0, sizeof(jsonValue_t));
+            if (level != NULL) {
+                value->name = level->name;
+                value->nameLength = level->nameLength;
+                value->inArray = level->type == '[';
+                value->index = level->index;
+            }
+            value->depth = tokenizer->depth;
+            if (c == '{' || c == '[') {
+                const uint8_t *start = tokenizer->cursor.ptr;
+
+                cursor_skip(&tokenizer->cursor, 1);
+                if (peekToken(tokenizer) == (c == '{' ? '}' : ']')) {
+                    // nothing below to name it, reviewed as is
+                    cursor_skip(&tokenizer->cursor, 1);
+                    value->data = start;
+                    value->length = tokenizer->cursor.ptr - start;
+                    endValue(tokenizer);
+                    return true;
+                }
+                if (tokenizer->depth == JSON_MAX_DEPTH) {
+                    PRINTF("json Too deep\n");
+                    THROW(EXCEPTION);
+                }
+                level = &tokenizer->levels[tokenizer->depth++];
+                level->type = c;
+                // arrays name their elements after their own key
+                level->name = c == '[' ? value->name : NULL;
+                level->nameLength = c == '[' ? value->nameLength : 0;
+                level->index = 0;
+                tokenizer->expect = c == '{' ? JSON_EXPECT_KEY : JSON_EXPECT_VALUE;
+                break;
+            }
+            if (c == '"') {
+                cursor_skip(&tokenizer->cursor, 1);
+                readString(tokenizer, &value->data, &value->length);
+                value->isString = true;
+            } else {
+                readLiteral(tokenizer, &value->data, &value->length);
+            }
+            endValue(tokenizer);
+            return true;
+        case JSON_EXPECT_NEXT:
+            if (c == ',') {
+                cursor_skip(&tokenizer->cursor, 1);
+                if (level->type == '{') {
+                    tokenizer->expect = JSON_EXPECT_KEY;
+                } else {
+                    level->index++;
+                    tokenizer->expect = JSON_EXPECT_VALUE;
+                }
+            } else if (c == (level->type == '{' ? '}' : ']')) {
+                closeLevel(tokenizer);
+            } else {
+                PRINTF("json Separator expected\n");
+                THROW(EXCEPTION);
+            }
+            break;
+        default:
+            THROW(EXCEPTION);
+        }
+    }
+}
+
+/**
+ * Text displayed for a string read by the tokenizer. Escapes of printable
+ * ASCII characters are decoded, the other escapes are kept as they are,
+ * and bytes outside of printable ASCII are shown as \xHH. A backslash is
+ * shown escaped, so that two different strings never display the same.
+ * Writes the characters from offset skip, up to size of them, without
+ * terminating them, and returns the length of the whole text.
+*/
+uint32_t json_display_string(const uint8_t *data, uint32_t length, uint32_t skip, char *out, uint32_t size) {
+    static const char HEX_DIGITS[] = "0123456789ABCDEF";
+    char text[6];
+    uint8_t textLength;
+    uint32_t total = 0;
+    uint32_t written = 0;
+    uint32_t i = 0;
+    uint8_t j;
+
+    while (i < length) {
+        uint8_t c = data[i++];
+
+        textLength = 1;
+        text[0] = c;
+        if (c == '\\') {
+            // the tokenizer checked the escapes
+            c = data[i++];
+            if (c == 'u') {
+                uint16_t code = 0;
+                for (j = 0; j < 4; ++j) {
+                    code = (code << 4) | hexDigitValue(data[i + j]);
+                }
+                if (code >= 0x20 && code < 0x7F && code != '\\') {
+                    text[0] = code;
+                } else if (code == '\\') {
+                    text[1] = '\\';
+                    textLength = 2;
+                } else {
+                    text[1] = 'u';
+                    os_memmove(text + 2, data + i, 4);
+                    textLength = 6;
+                }
+                i += 4;
+            } else if (c == '"' || c == '/') {
+                text[0] = c;
+            } else {
+                text[1] = c;
+                textLength = 2;
+            }
+        } else if (c < 0x20 || c >= 0x7F) {
+            text[0] = '\\';
+            text[1] = 'x';
+            text[2] = ((const char *)PIC(HEX_DIGITS))[c >> 4];
+            text[3] = ((const char *)PIC(HEX_DIGITS))[c & 0x0F];
+            textLength = 4;
+        }
+        for (j = 0; j < textLength; ++j, ++total) {
+            if (out != NULL && total >= skip && written < size) {
+                out[written++] = text[j];
+            }
+        }
+    }
+    return total;
+}
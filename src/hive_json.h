@@ -0,0 +1,95 @@
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __HIVE_JSON_H__
+#define __HIVE_JSON_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hive_cursor.h"
+
+// objects and arrays nested deeper are refused
+#define JSON_MAX_DEPTH 8
+
+typedef enum jsonExpect_e {
+    JSON_EXPECT_VALUE,
+    JSON_EXPECT_KEY,
+    JSON_EXPECT_NEXT,
+    JSON_EXPECT_DONE
+} jsonExpect_e;
+
+/**
+ * An open object or array. The name is the key the container is the
+ * value of, for array elements, or the last key read, for objects.
+*/
+typedef struct jsonLevel_t {
+    uint8_t type;
+    const uint8_t *name;
+    uint8_t nameLength;
+    uint16_t index;
+} jsonLevel_t;
+
+/**
+ * Tokenizer walking a JSON document in a single pass with a bounded
+ * stack, without copying it. Each call returns the next scalar value
+ * along with the key naming it, or the index of its array. The whole
+ * document is checked: malformed JSON, too deep nesting or data after
+ * the document throw.
+*/
+typedef struct jsonTokenizer_t {
+    cursor_t cursor;
+    jsonExpect_e expect;
+    uint8_t depth;
+    jsonLevel_t levels[JSON_MAX_DEPTH];
+} jsonTokenizer_t;
+
+typedef struct jsonValue_t {
+    // without the quotes for strings, escapes are kept
+    const uint8_t *data;
+    uint32_t length;
+    bool isString;
+    // key of the value, or of its array then index is set
+    const uint8_t *name;
+    uint8_t nameLength;
+    bool inArray;
+    uint16_t index;
+    // of the enclosing containers, 0 for a document holding a single value
+    uint8_t depth;
+} jsonValue_t;
+
+/**
+ * Review label of a key of a known document layout.
+*/
+typedef struct jsonField_t {
+    const char *key;
+    const char *label;
+} jsonField_t;
+
+/**
+ * Labels of a known document layout, keys not listed keep their name.
+ * The first element of a top-level array names the action.
+*/
+typedef struct jsonLayout_t {
+    const jsonField_t *fields;
+    uint8_t fieldCount;
+} jsonLayout_t;
+
+void json_init(jsonTokenizer_t *tokenizer, uint8_t *data, uint32_t length);
+bool json_next_value(jsonTokenizer_t *tokenizer, jsonValue_t *value);
+uint32_t json_display_string(const uint8_t *data, uint32_t length, uint32_t skip, char *out, uint32_t size);
+
+#endif // __HIVE_JSON_H__
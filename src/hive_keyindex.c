@@ -0,0 +1,107 @@
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "os.h"
+#include "cx.h"
+#include "hive_keyindex.h"
+#include <string.h>
+
+typedef struct ownKey_t {
+    uint8_t key[33];
+    uint8_t role;
+    uint8_t account;
+} ownKey_t;
+
+typedef struct ownKeyIndex_t {
+    ownKey_t keys[KEY_INDEX_SIZE];
+    uint8_t count;
+} ownKeyIndex_t;
+
+static const uint8_t keyIndexRoles[KEY_INDEX_ROLES] = {0, 1, 3, 4};
+
+static ownKeyIndex_t keyIndex;
+
+/**
+ * Derive the next key and insert it at its sorted position.
+ * Returns false once every key is indexed.
+*/
+bool hive_keyindex_build_step(void) {
+    uint8_t privateKeyData[64];
+    uint32_t path[5];
+    cx_ecfp_private_key_t privateKey;
+    cx_ecfp_public_key_t publicKey;
+    ownKey_t entry;
+    uint8_t i;
+
+    if (keyIndex.count == KEY_INDEX_SIZE) {
+        return false;
+    }
+
+    entry.role = keyIndexRoles[keyIndex.count % KEY_INDEX_ROLES];
+    entry.account = keyIndex.count / KEY_INDEX_ROLES;
+
+    path[0] = 0x80000000 | 48;
+    path[1] = 0x80000000 | 13;
+    path[2] = 0x80000000 | entry.role;
+    path[3] = 0x80000000 | entry.account;
+    path[4] = 0x80000000;
+    os_perso_derive_node_bip32(CX_CURVE_256K1, path, 5, privateKeyData, NULL);
+    cx_ecfp_init_private_key(CX_CURVE_256K1, privateKeyData, 32, &privateKey);
+    cx_ecfp_generate_pair(CX_CURVE_256K1, &publicKey, &privateKey, 1);
+    os_memset(&privateKey, 0, sizeof(privateKey));
+    os_memset(privateKeyData, 0, sizeof(privateKeyData));
+
+    entry.key[0] = (publicKey.W[64] & 0x1) ? 0x03 : 0x02;
+    os_memmove(entry.key + 1, publicKey.W + 1, 32);
+
+    for (i = keyIndex.count; i > 0 && memcmp(keyIndex.keys[i - 1].key, entry.key, sizeof(entry.key)) > 0; --i) {
+        os_memmove(&keyIndex.keys[i], &keyIndex.keys[i - 1], sizeof(ownKey_t));
+    }
+    os_memmove(&keyIndex.keys[i], &entry, sizeof(ownKey_t));
+    keyIndex.count++;
+    return true;
+}
+
+/**
+ * Look a compressed public key up, completing the index first.
+ * Writes the path of the key when it belongs to this device.
+*/
+bool hive_keyindex_find(const uint8_t *key, char *path, uint32_t pathSize) {
+    uint8_t low = 0;
+    uint8_t high;
+
+    while (hive_keyindex_build_step()) {
+    }
+
+    high = keyIndex.count;
+    while (low < high) {
+        uint8_t middle = (low + high) / 2;
+        int order = memcmp(keyIndex.keys[middle].key, key, sizeof(keyIndex.keys[middle].key));
+
+        if (order == 0) {
+            snprintf(path, pathSize, "48'/13'/%d'/%d'/0'",
+                     keyIndex.keys[middle].role, keyIndex.keys[middle].account);
+            return true;
+        }
+        if (order < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,44 @@
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __HIVE_KEYINDEX_H__
+#define __HIVE_KEYINDEX_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// owner, active, memo and posting keys of the first accounts
+#define KEY_INDEX_ROLES 4
+#if defined(TARGET_NANOX)
+#define KEY_INDEX_ACCOUNTS 5
+#else
+#define KEY_INDEX_ACCOUNTS 2
+#endif
+#define KEY_INDEX_SIZE (KEY_INDEX_ROLES * KEY_INDEX_ACCOUNTS)
+
+// longest path text, 48'/13'/role'/account'/0'
+#define KEY_INDEX_PATH_LENGTH 32
+
+/**
+ * Compressed public keys of this device at 48'/13'/role'/account'/0',
+ * sorted so that authority keys are matched without base58 conversion.
+ * The index is derived one key at a time and kept for the app lifetime.
+*/
+bool hive_keyindex_build_step(void);
+bool hive_keyindex_find(const uint8_t *key, char *path, uint32_t pathSize);
+
+#endif // __HIVE_KEYINDEX_H__
@@ -0,0 +1,97 @@
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "os.h"
+#include "hive_lz.h"
+
+// chain id field, asset symbols and frequent custom_json keys
+static const uint8_t lzDictionary[LZ_WINDOW] = {
+    0x00, 0x00, 0x00, 0x04, 0x20, 0xbe, 0xea, 0xb0, 0xde, 0x04, 0x02, 0x04,
+    0x04, 0x03, 0x53, 0x54, 0x45, 0x45, 0x4d, 0x00, 0x00, 0x03, 0x53, 0x42,
+    0x44, 0x00, 0x00, 0x00, 0x00, 0x06, 0x56, 0x45, 0x53, 0x54, 0x53, 0x00,
+    0x00, 0x5b, 0x22, 0x66, 0x6f, 0x6c, 0x6c, 0x6f, 0x77, 0x22, 0x2c, 0x7b,
+    0x22, 0x66, 0x6f, 0x6c, 0x6c, 0x6f, 0x77, 0x65, 0x72, 0x22, 0x3a, 0x22,
+    0x22, 0x2c, 0x22, 0x66, 0x6f, 0x6c, 0x6c, 0x6f, 0x77, 0x69, 0x6e, 0x67,
+    0x22, 0x3a, 0x22, 0x22, 0x2c, 0x22, 0x77, 0x68, 0x61, 0x74, 0x22, 0x3a,
+    0x5b, 0x22, 0x62, 0x6c, 0x6f, 0x67, 0x22, 0x5d, 0x7d, 0x5d, 0x5b, 0x22,
+    0x72, 0x65, 0x62, 0x6c, 0x6f, 0x67, 0x22, 0x2c, 0x7b, 0x22, 0x61, 0x63,
+    0x63, 0x6f, 0x75, 0x6e, 0x74, 0x22, 0x3a, 0x22, 0x22, 0x2c, 0x22, 0x61,
+    0x75, 0x74, 0x68, 0x6f, 0x72, 0x22, 0x3a, 0x22, 0x22, 0x2c, 0x22, 0x70,
+    0x65, 0x72, 0x6d, 0x6c, 0x69, 0x6e, 0x6b, 0x22, 0x3a, 0x22, 0x7b, 0x22,
+    0x63, 0x6f, 0x6e, 0x74, 0x72, 0x61, 0x63, 0x74, 0x4e, 0x61, 0x6d, 0x65,
+    0x22, 0x3a, 0x22, 0x74, 0x6f, 0x6b, 0x65, 0x6e, 0x73, 0x22, 0x2c, 0x22,
+    0x63, 0x6f, 0x6e, 0x74, 0x72, 0x61, 0x63, 0x74, 0x41, 0x63, 0x74, 0x69,
+    0x6f, 0x6e, 0x22, 0x3a, 0x22, 0x74, 0x72, 0x61, 0x6e, 0x73, 0x66, 0x65,
+    0x72, 0x22, 0x2c, 0x22, 0x63, 0x6f, 0x6e, 0x74, 0x72, 0x61, 0x63, 0x74,
+    0x50, 0x61, 0x79, 0x6c, 0x6f, 0x61, 0x64, 0x22, 0x3a, 0x7b, 0x22, 0x73,
+    0x79, 0x6d, 0x62, 0x6f, 0x6c, 0x22, 0x3a, 0x22, 0x22, 0x2c, 0x22, 0x74,
+    0x6f, 0x22, 0x3a, 0x22, 0x22, 0x2c, 0x22, 0x71, 0x75, 0x61, 0x6e, 0x74,
+    0x69, 0x74, 0x79, 0x22, 0x3a, 0x22, 0x22, 0x2c, 0x22, 0x6d, 0x65, 0x6d,
+    0x6f, 0x22, 0x3a, 0x22,};
+
+void lz_init(lzStream_t *lz) {
+    os_memset(lz, 0, sizeof(lzStream_t));
+    os_memmove(lz->ring, (const void *)PIC(lzDictionary), LZ_WINDOW);
+}
+
+/**
+ * Decode from in into the window, up to its end so that the output is
+ * contiguous. Only call once the previous output has been consumed.
+ * Returns the number of decoded bytes, out points to them.
+*/
+uint32_t lz_inflate(lzStream_t *lz, cursor_t *in, uint8_t **out) {
+    uint32_t room = LZ_WINDOW - lz->pos;
+    uint32_t count = 0;
+
+    *out = lz->ring + lz->pos;
+    while (count < room) {
+        if (lz->matchLeft != 0) {
+            // a distance of 256 reads the byte about to be replaced
+            lz->ring[lz->pos] = lz->ring[(uint8_t)(lz->pos - lz->matchDistance - 1)];
+            lz->matchLeft--;
+        } else if (cursor_remaining(in) == 0) {
+            break;
+        } else if (lz->literalLeft != 0) {
+            lz->ring[lz->pos] = cursor_read_u8(in);
+            lz->literalLeft--;
+        } else if (lz->needDistance) {
+            lz->matchDistance = cursor_read_u8(in);
+            lz->matchLeft = lz->matchLength;
+            lz->needDistance = false;
+            continue;
+        } else {
+            uint8_t token = cursor_read_u8(in);
+            if (token & LZ_MATCH_FLAG) {
+                lz->matchLength = (token & ~LZ_MATCH_FLAG) + LZ_MIN_MATCH;
+                lz->needDistance = true;
+            } else {
+                lz->literalLeft = token + 1;
+            }
+            continue;
+        }
+        lz->pos++;
+        count++;
+    }
+    return count;
+}
+
+/**
+ * True when no token is partially decoded.
+*/
+bool lz_idle(lzStream_t *lz) {
+    return lz->matchLeft == 0 && lz->literalLeft == 0 && !lz->needDistance;
+}
@@ -0,0 +1,53 @@
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __HIVE_LZ_H__
+#define __HIVE_LZ_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hive_cursor.h"
+
+#define LZ_WINDOW 256
+
+// token byte below this value: literal run of (token + 1) bytes
+#define LZ_MATCH_FLAG 0x80
+#define LZ_MIN_MATCH 3
+
+/**
+ * Streaming decoder of the compressed transaction framing.
+ * Tokens are either a literal run or a match of up to 130 bytes,
+ * followed by its distance (1 to 256) in the history window. The window
+ * starts out holding a dictionary of common Hive serializations, then
+ * the latest decoded bytes, such as the accounts already seen.
+ * Decoding state survives across commands, tokens may be split anywhere.
+*/
+typedef struct lzStream_t {
+    uint8_t ring[LZ_WINDOW];
+    uint8_t pos;
+    uint8_t literalLeft;
+    uint8_t matchLeft;
+    uint8_t matchLength;
+    uint8_t matchDistance;
+    bool needDistance;
+} lzStream_t;
+
+void lz_init(lzStream_t *lz);
+uint32_t lz_inflate(lzStream_t *lz, cursor_t *in, uint8_t **out);
+bool lz_idle(lzStream_t *lz);
+
+#endif // __HIVE_LZ_H__
@@ -0,0 +1,272 @@
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "hive_memo.h"
+#include "hive_cursor.h"
+#include <string.h>
+
+#define HARDENED 0x80000000
+
+static const uint32_t MEMO_ROLE_PREFIX[] = {48 | HARDENED, 13 | HARDENED, 3 | HARDENED};
+
+// secp256k1 field prime, and (p + 1) / 4 for its square roots
+static const uint8_t FIELD_PRIME[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xFF, 0xFF, 0xFC, 0x2F};
+static const uint8_t SQRT_EXPONENT[32] = {
+    0x3F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xBF, 0xFF, 0xFF, 0x0C};
+static const uint8_t CURVE_B[32] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07};
+
+#define MEMO_RECORD_HEADER (33 + 8 + 4 + 1)
+#define AES_BLOCK 16
+// returned instead of a plaintext length when a memo does not decrypt
+#define MEMO_UNREADABLE 0xFF
+
+static bool isMemoPath(hiveMemoBatch_t *batch) {
+    return batch->pathLength == HIVE_MEMO_PATH_LENGTH &&
+           memcmp(batch->path, MEMO_ROLE_PREFIX, sizeof(MEMO_ROLE_PREFIX)) == 0;
+}
+
+/**
+ * BIP 32 path of a memo key, 48'/13'/3'/account'/index'.
+*/
+uint32_t hive_memo_parse_path(hiveMemoBatch_t *batch, uint8_t *buffer, uint32_t length) {
+    cursor_t cursor;
+    uint8_t *p;
+    uint32_t i;
+
+    hive_memo_end(batch);
+    cursor_init(&cursor, buffer, length);
+
+    batch->pathLength = cursor_read_u8(&cursor);
+    if (batch->pathLength != HIVE_MEMO_PATH_LENGTH) {
+        THROW(0x6a80);
+    }
+    for (i = 0; i < batch->pathLength; i++) {
+        p = cursor_read_bytes(&cursor, 4);
+        batch->path[i] = (p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+    }
+    if (!isMemoPath(batch)) {
+        PRINTF("Not a memo key\n");
+        THROW(0x6a80);
+    }
+    return length - cursor_remaining(&cursor);
+}
+
+/**
+ * Derive the memo key of the approved path. Returns false, without
+ * deriving anything, if the batch no longer holds a memo key path.
+*/
+bool hive_memo_begin(hiveMemoBatch_t *batch) {
+    uint8_t privateKeyData[64];
+
+    if (!isMemoPath(batch)) {
+        hive_memo_end(batch);
+        return false;
+    }
+
+    os_perso_derive_node_bip32(CX_CURVE_256K1, batch->path, batch->pathLength,
+                               privateKeyData, NULL);
+    cx_ecfp_init_private_key(CX_CURVE_256K1, privateKeyData, 32, &batch->privateKey);
+    os_memset(privateKeyData, 0, sizeof(privateKeyData));
+    batch->active = true;
+    return true;
+}
+
+void hive_memo_end(hiveMemoBatch_t *batch) {
+    os_memset(batch, 0, sizeof(hiveMemoBatch_t));
+}
+
+/**
+ * Uncompress a public key, y being the square root of x^3 + 7 with the
+ * parity of the prefix. Returns false for a key that is not on the curve,
+ * the memo writer chooses it.
+*/
+static bool uncompressPublicKey(const uint8_t *compressed, uint8_t *point) {
+    uint8_t square[32];
+    uint8_t y[32];
+
+    if ((compressed[0] != 0x02 && compressed[0] != 0x03) ||
+        cx_math_cmp((uint8_t *)compressed + 1, (uint8_t *)FIELD_PRIME, 32) >= 0) {
+        return false;
+    }
+    cx_math_multm(square, compressed + 1, compressed + 1, FIELD_PRIME, 32);
+    cx_math_multm(square, square, compressed + 1, FIELD_PRIME, 32);
+    cx_math_addm(square, square, CURVE_B, FIELD_PRIME, 32);
+    cx_math_powm(y, square, SQRT_EXPONENT, 32, FIELD_PRIME, 32);
+    if ((y[31] & 1) != (compressed[0] & 1)) {
+        cx_math_sub(y, FIELD_PRIME, y, 32);
+    }
+
+    point[0] = 0x04;
+    os_memmove(point + 1, compressed + 1, 32);
+    os_memmove(point + 33, y, 32);
+    cx_math_multm(y, y, y, FIELD_PRIME, 32);
+    if (memcmp(y, square, 32) != 0) {
+        PRINTF("Invalid public key\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Shared secret with the other party of a memo, computed once per party
+ * while it stays among the last ones seen. NULL if its key is invalid.
+*/
+static const uint8_t *sharedSecret(hiveMemoBatch_t *batch, const uint8_t *publicKey) {
+    cx_sha512_t sha512;
+    memoSecret_t *entry;
+    uint8_t point[65];
+    uint8_t x[32];
+    uint8_t i;
+
+    for (i = 0; i < batch->secretCount; ++i) {
+        if (memcmp(batch->secrets[i].publicKey, publicKey, sizeof(batch->secrets[i].publicKey)) == 0) {
+            return batch->secrets[i].secret;
+        }
+    }
+
+    if (!uncompressPublicKey(publicKey, point)) {
+        return NULL;
+    }
+    cx_ecdh(&batch->privateKey, CX_ECDH_X, point, sizeof(point), x, sizeof(x));
+
+    entry = &batch->secrets[batch->nextSecret];
+    batch->nextSecret = (batch->nextSecret + 1) % HIVE_MEMO_SECRETS;
+    if (batch->secretCount < HIVE_MEMO_SECRETS) {
+        batch->secretCount++;
+    }
+    os_memmove(entry->publicKey, publicKey, sizeof(entry->publicKey));
+    cx_sha512_init(&sha512);
+    cx_hash(&sha512.header, CX_LAST, x, sizeof(x), entry->secret, sizeof(entry->secret));
+    os_memset(x, 0, sizeof(x));
+    return entry->secret;
+}
+
+/**
+ * Decrypt one memo in place, AES-256-CBC keyed by sha512(nonce || secret)
+ * whose sha256 starts with the checksum. Returns the length of the
+ * serialized plaintext, or MEMO_UNREADABLE.
+*/
+static uint32_t decryptMemo(const uint8_t *secret, const uint8_t *nonce, const uint8_t *checksum,
+                            uint8_t *data, uint32_t length) {
+    cx_sha512_t sha512;
+    cx_sha256_t sha256;
+    cx_aes_key_t aesKey;
+    uint8_t encryptionKey[64];
+    uint8_t check[32];
+    uint8_t previous[AES_BLOCK];
+    uint8_t block[AES_BLOCK];
+    uint8_t padding;
+    uint32_t offset;
+    uint8_t i;
+
+    cx_sha512_init(&sha512);
+    cx_hash(&sha512.header, 0, (uint8_t *)nonce, 8, NULL, 0);
+    cx_hash(&sha512.header, CX_LAST, (uint8_t *)secret, 64, encryptionKey, sizeof(encryptionKey));
+    cx_sha256_init(&sha256);
+    cx_hash(&sha256.header, CX_LAST, encryptionKey, sizeof(encryptionKey), check, sizeof(check));
+    if (memcmp(check, checksum, 4) != 0) {
+        os_memset(encryptionKey, 0, sizeof(encryptionKey));
+        return MEMO_UNREADABLE;
+    }
+
+    cx_aes_init_key(encryptionKey, 32, &aesKey);
+    os_memmove(previous, encryptionKey + 32, AES_BLOCK);
+    os_memset(encryptionKey, 0, sizeof(encryptionKey));
+    for (offset = 0; offset < length; offset += AES_BLOCK) {
+        os_memmove(block, data + offset, AES_BLOCK);
+        cx_aes(&aesKey, CX_DECRYPT | CX_CHAIN_ECB | CX_PAD_NONE | CX_LAST, block, AES_BLOCK, data + offset);
+        for (i = 0; i < AES_BLOCK; ++i) {
+            data[offset + i] ^= previous[i];
+        }
+        os_memmove(previous, block, AES_BLOCK);
+    }
+    os_memset(&aesKey, 0, sizeof(aesKey));
+
+    // PKCS#7 padding
+    padding = data[length - 1];
+    if (padding == 0 || padding > AES_BLOCK) {
+        return MEMO_UNREADABLE;
+    }
+    for (i = 0; i < padding; ++i) {
+        if (data[length - 1 - i] != padding) {
+            return MEMO_UNREADABLE;
+        }
+    }
+    return length - padding;
+}
+
+/**
+ * Decrypt a command of memo records, each made of the public key of the
+ * other party, the nonce, the checksum, the ciphertext length and the
+ * ciphertext. Each record is answered with the length of its message
+ * followed by the message, or MEMO_UNREADABLE alone. Answers are written
+ * over the records, which are always longer.
+ * Returns the length of the answers.
+*/
+uint32_t hive_memo_decrypt(hiveMemoBatch_t *batch, uint8_t *buffer, uint32_t length) {
+    cursor_t records;
+    cursor_t message;
+    uint32_t out = 0;
+
+    if (!batch->active) {
+        THROW(0x6985);
+    }
+    cursor_init(&records, buffer, length);
+    while (cursor_remaining(&records) != 0) {
+        uint8_t *record = cursor_read_bytes(&records, MEMO_RECORD_HEADER);
+        uint32_t cipherLength = record[MEMO_RECORD_HEADER - 1];
+        uint8_t *cipher = cursor_read_bytes(&records, cipherLength);
+        const uint8_t *secret;
+        uint32_t plainLength;
+        uint32_t messageLength;
+
+        if (cipherLength == 0 || (cipherLength % AES_BLOCK) != 0) {
+            THROW(0x6a80);
+        }
+        // one bad record does not cost the answers of the others
+        secret = sharedSecret(batch, record);
+        if (secret == NULL) {
+            buffer[out++] = MEMO_UNREADABLE;
+            continue;
+        }
+        plainLength = decryptMemo(secret, record + 33, record + 33 + 8, cipher, cipherLength);
+        if (plainLength == MEMO_UNREADABLE || plainLength == 0) {
+            buffer[out++] = MEMO_UNREADABLE;
+            continue;
+        }
+
+        // the message is serialized as a string, shorter than MEMO_UNREADABLE
+        cursor_init(&message, cipher, plainLength);
+        messageLength = cursor_read_u8(&message);
+        if ((messageLength & 0x80) && cursor_remaining(&message) != 0) {
+            messageLength = (messageLength & 0x7f) | ((uint32_t)cursor_read_u8(&message) << 7);
+        }
+        if (messageLength != cursor_remaining(&message) || messageLength >= MEMO_UNREADABLE) {
+            buffer[out++] = MEMO_UNREADABLE;
+            continue;
+        }
+        buffer[out++] = messageLength;
+        os_memmove(buffer + out, message.ptr, messageLength);
+        out += messageLength;
+    }
+    return out;
+}
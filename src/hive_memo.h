@@ -0,0 +1,62 @@
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __HIVE_MEMO_H__
+#define __HIVE_MEMO_H__
+
+#include "os.h"
+#include "cx.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#define HIVE_MEMO_PATH_LENGTH 5
+
+// shared secrets kept per other party of the memos
+#if defined(TARGET_NANOX)
+#define HIVE_MEMO_SECRETS 8
+#else
+#define HIVE_MEMO_SECRETS 2
+#endif
+
+typedef struct memoSecret_t {
+    uint8_t publicKey[33];
+    // sha512 of the ECDH x coordinate
+    uint8_t secret[64];
+} memoSecret_t;
+
+/**
+ * Memo key approved by the user to decrypt a batch of memos. It is
+ * derived once for the batch and kept in RAM until the batch ends or
+ * the application exits, along with the shared secrets of the last
+ * parties seen.
+*/
+typedef struct hiveMemoBatch_t {
+    bool active;
+    uint8_t pathLength;
+    uint32_t path[HIVE_MEMO_PATH_LENGTH];
+    cx_ecfp_private_key_t privateKey;
+    uint8_t secretCount;
+    uint8_t nextSecret;
+    memoSecret_t secrets[HIVE_MEMO_SECRETS];
+} hiveMemoBatch_t;
+
+uint32_t hive_memo_parse_path(hiveMemoBatch_t *batch, uint8_t *buffer, uint32_t length);
+bool hive_memo_begin(hiveMemoBatch_t *batch);
+void hive_memo_end(hiveMemoBatch_t *batch);
+uint32_t hive_memo_decrypt(hiveMemoBatch_t *batch, uint8_t *buffer, uint32_t length);
+
+#endif // __HIVE_MEMO_H__
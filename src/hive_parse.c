@@ -20,27 +20,14 @@
 #include "cx.h"
 #include "hive_types.h"
 #include "hive_utils.h"
+#include "hive_keyindex.h"
+#include "hive_address_book.h"
 #include <stdbool.h>
 #include <string.h>
 
-void printString(const char in[], const char fieldName[], actionArgument_t *arg) {
-    uint32_t inLength = strlen(in);
-    uint32_t labelLength = strlen(fieldName);
-
-    os_memset(arg->label, 0, sizeof(arg->label));
-    os_memset(arg->data, 0, sizeof(arg->data));
-
-    os_memmove(arg->label, fieldName, labelLength);
-    os_memmove(arg->data, in, inLength);
-}
-
-void parsePublicKeyField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
-    if (inLength < 33) {
-        PRINTF("parseActionData Insufficient buffer\n");
-        THROW(EXCEPTION);
-    }
+static void setLabel(const char fieldName[], actionArgument_t *arg) {
     uint32_t labelLength = strlen(fieldName);
-    if (labelLength > sizeof(arg->label)) {
+    if (labelLength > sizeof(arg->label) - 1) {
         PRINTF("parseActionData Label too long\n");
         THROW(EXCEPTION);
     }
@@ -49,160 +36,325 @@ void parsePublicKeyField(uint8_t *in, uint32_t inLength, const char fieldName[],
     os_memset(arg->data, 0, sizeof(arg->data));
 
     os_memmove(arg->label, fieldName, labelLength);
-    uint32_t writtenToBuff = compressed_public_key_to_wif(in, 33, arg->data, sizeof(arg->data)-1);
-
-    *read = 33;
-    *written = writtenToBuff;
 }
 
-void parseUint16Field(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
-    if (inLength < sizeof(uint16_t)) {
-        PRINTF("parseActionData Insufficient buffer\n");
-        THROW(EXCEPTION);
-    }
-    uint32_t labelLength = strlen(fieldName);
-    if (labelLength > sizeof(arg->label)) {
-        PRINTF("parseActionData Label too long\n");
+void printString(const char in[], const char fieldName[], actionArgument_t *arg) {
+    uint32_t inLength = strlen(in);
+    if (inLength > sizeof(arg->data) - 1) {
+        PRINTF("printString Insufficient buffer\n");
         THROW(EXCEPTION);
     }
 
-    os_memset(arg->label, 0, sizeof(arg->label));
-    os_memset(arg->data, 0, sizeof(arg->data));
+    setLabel(fieldName, arg);
+    os_memmove(arg->data, in, inLength);
+}
 
-    os_memmove(arg->label, fieldName, labelLength);
-    uint16_t value;
-    os_memmove(&value, in, sizeof(uint16_t));
-    snprintf(arg->data, sizeof(arg->data)-1, "%d", value);
+void parsePublicKeyField(cursor_t *cursor, const char fieldName[], actionArgument_t *arg) {
+    setLabel(fieldName, arg);
+    compressed_public_key_to_wif(cursor_read_bytes(cursor, 33), 33, arg->data, sizeof(arg->data) - 1);
+}
 
-    *read = sizeof(uint16_t);
-    *written = strlen(arg->data);
+void parseUint16Field(cursor_t *cursor, const char fieldName[], actionArgument_t *arg) {
+    setLabel(fieldName, arg);
+    snprintf(arg->data, sizeof(arg->data) - 1, "%d", cursor_read_u16(cursor));
 }
 
-void parseUint32Field(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
-    if (inLength < sizeof(uint32_t)) {
-        PRINTF("parseActionData Insufficient buffer\n");
-        THROW(EXCEPTION);
-    }
-    uint32_t labelLength = strlen(fieldName);
-    if (labelLength > sizeof(arg->label)) {
-        PRINTF("parseActionData Label too long\n");
-        THROW(EXCEPTION);
-    }
+void parseUint32Field(cursor_t *cursor, const char fieldName[], actionArgument_t *arg) {
+    setLabel(fieldName, arg);
+    snprintf(arg->data, sizeof(arg->data) - 1, "%u", cursor_read_u32(cursor));
+}
 
-    os_memset(arg->label, 0, sizeof(arg->label));
-    os_memset(arg->data, 0, sizeof(arg->data));
+void parseInt64Field(cursor_t *cursor, const char fieldName[], actionArgument_t *arg) {
+    setLabel(fieldName, arg);
+    i64toa((int64_t)cursor_read_u64(cursor), arg->data);
+}
 
-    os_memmove(arg->label, fieldName, labelLength);
-    uint32_t value;
-    os_memmove(&value, in, sizeof(uint32_t));
-    snprintf(arg->data, sizeof(arg->data)-1, "%d", value);
+void parseUInt64Field(cursor_t *cursor, const char fieldName[], actionArgument_t *arg) {
+    setLabel(fieldName, arg);
+    ui64toa(cursor_read_u64(cursor), arg->data);
+}
 
-    *read = sizeof(uint32_t);
-    *written = strlen(arg->data);
+void parseAssetField(cursor_t *cursor, const char fieldName[], actionArgument_t *arg) {
+    asset_t asset;
+    setLabel(fieldName, arg);
+    cursor_read_asset(cursor, &asset);
+    asset_to_string(&asset, arg->data, sizeof(arg->data) - 1);
 }
 
-void parseInt64Field(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
-    if (inLength < sizeof(int64_t)) {
+void parseStringField(cursor_t *cursor, const char fieldName[], actionArgument_t *arg) {
+    setLabel(fieldName, arg);
+
+    uint32_t fieldLength = cursor_read_varint(cursor);
+    if (fieldLength > sizeof(arg->data) - 1) {
         PRINTF("parseActionData Insufficient buffer\n");
         THROW(EXCEPTION);
     }
-    uint32_t labelLength = strlen(fieldName);
-    if (labelLength > sizeof(arg->label)) {
-        PRINTF("parseActionData Label too long\n");
-        THROW(EXCEPTION);
-    }
-
-    os_memset(arg->label, 0, sizeof(arg->label));
-    os_memset(arg->data, 0, sizeof(arg->data));
 
-    os_memmove(arg->label, fieldName, labelLength);
-    int64_t value;
-    os_memmove(&value, in, sizeof(int64_t));
-    i64toa(value, arg->data);
-
-    *read = sizeof(uint64_t);
-    *written = strlen(arg->data);
+    os_memmove(arg->data, cursor_read_bytes(cursor, fieldLength), fieldLength);
 }
 
-void parseUInt64Field(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
-    if (inLength < sizeof(uint64_t)) {
-        PRINTF("parseActionData Insufficient buffer\n");
-        THROW(EXCEPTION);
-    }
-    uint32_t labelLength = strlen(fieldName);
-    if (labelLength > sizeof(arg->label)) {
-        PRINTF("parseActionData Label too long\n");
-        THROW(EXCEPTION);
+/**
+ * Account receiving funds, marked when it is in the address book.
+*/
+void parseRecipientField(cursor_t *cursor, const char fieldName[], actionArgument_t *arg) {
+    parseStringField(cursor, fieldName, arg);
+    if (hive_address_book_contains(arg->data, strlen(arg->data))) {
+        snprintf(arg->data + strlen(arg->data), sizeof(arg->data) - strlen(arg->data), " - trusted");
     }
+}
 
-    os_memset(arg->label, 0, sizeof(arg->label));
-    os_memset(arg->data, 0, sizeof(arg->data));
+void parseBoolField(cursor_t *cursor, const char fieldName[], actionArgument_t *arg) {
+    printString(cursor_read_u8(cursor) == 0x01 ? "true" : "false", fieldName, arg);
+}
 
-    os_memmove(arg->label, fieldName, labelLength);
-    uint64_t value;
-    os_memmove(&value, in, sizeof(uint64_t));
-    ui64toa(value, arg->data);
+// public key and weight
+#define AUTHORITY_KEY_SIZE (sizeof(public_key_t) + sizeof(uint16_t))
 
-    *read = sizeof(uint64_t);
-    *written = strlen(arg->data);
+static void appendWeight(cursor_t *cursor, actionArgument_t *arg) {
+    snprintf(arg->data + strlen(arg->data), sizeof(arg->data) - strlen(arg->data), " (weight %d)", cursor_read_u16(cursor));
 }
 
-void parseAssetField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
-    if (inLength < sizeof(asset_t)) {
-        PRINTF("parseActionData Insufficient buffer\n");
-        THROW(EXCEPTION);
+/**
+ * Mark a compressed public key derived by this device with its path.
+*/
+void appendOwnKey(const uint8_t *key, actionArgument_t *arg) {
+    char path[KEY_INDEX_PATH_LENGTH];
+
+    if (hive_keyindex_find(key, path, sizeof(path))) {
+        snprintf(arg->data + strlen(arg->data), sizeof(arg->data) - strlen(arg->data), " - this device: %s", path);
     }
+}
 
-    uint32_t labelLength = strlen(fieldName);
-    if (labelLength > sizeof(arg->label)) {
-        PRINTF("parseActionData Label too long\n");
-        THROW(EXCEPTION);
+/**
+ * An authority is a weight threshold followed by the weighted account
+ * and key lists. It is reviewed on one page for the threshold, then one
+ * page per account and per key, starting at *page.
+ * The lists are indexed without formatting anything: account names are
+ * only skipped, and keys having a fixed size are reached directly, so
+ * only the displayed entry is converted.
+ * Returns true when page argNum belongs to the authority and has been
+ * printed, otherwise moves *page past the authority.
+*/
+bool parseAuthorityPages(cursor_t *cursor, const char fieldName[], uint8_t *page, uint8_t argNum, actionArgument_t *arg) {
+    char label[sizeof(arg->label)];
+    uint32_t threshold = cursor_read_u32(cursor);
+    uint32_t accountCount = cursor_read_varint(cursor);
+    cursor_t accounts = *cursor;
+    uint32_t keyCount;
+    cursor_t keys;
+    uint32_t entry;
+    uint32_t i;
+
+    if (accountCount > MAX_ARGUMENT_COUNT) {
+        THROW(EXCEPTION_OVERFLOW);
+    }
+    for (i = 0; i < accountCount; ++i) {
+        cursor_skip(cursor, cursor_read_varint(cursor));
+        cursor_skip(cursor, sizeof(uint16_t));
     }
 
-    os_memset(arg->label, 0, sizeof(arg->label));
-    os_memset(arg->data, 0, sizeof(arg->data));
+    keyCount = cursor_read_varint(cursor);
+    if (keyCount > MAX_ARGUMENT_COUNT || *page + 1 + accountCount + keyCount > MAX_ARGUMENT_COUNT) {
+        THROW(EXCEPTION_OVERFLOW);
+    }
+    keys = *cursor;
+    cursor_skip(cursor, keyCount * AUTHORITY_KEY_SIZE);
 
-    os_memmove(arg->label, fieldName, labelLength);
-    asset_t asset;
-    os_memmove(&asset, in, sizeof(asset));
-    uint32_t writtenToBuff = asset_to_string(&asset, arg->data, sizeof(arg->data)-1); 
+    if (argNum < *page || argNum - *page > accountCount + keyCount) {
+        *page += 1 + accountCount + keyCount;
+        return false;
+    }
 
-    *read = sizeof(asset_t);
-    *written = writtenToBuff;
+    entry = argNum - *page;
+    if (entry == 0) {
+        snprintf(label, sizeof(label), "%s Threshold", fieldName);
+        setLabel(label, arg);
+        snprintf(arg->data, sizeof(arg->data) - 1, "%u", threshold);
+    } else if (entry <= accountCount) {
+        for (i = 1; i < entry; ++i) {
+            cursor_skip(&accounts, cursor_read_varint(&accounts));
+            cursor_skip(&accounts, sizeof(uint16_t));
+        }
+        snprintf(label, sizeof(label), "%s Account %u", fieldName, entry);
+        parseStringField(&accounts, label, arg);
+        appendWeight(&accounts, arg);
+    } else {
+        entry -= accountCount;
+        cursor_skip(&keys, (entry - 1) * AUTHORITY_KEY_SIZE);
+        snprintf(label, sizeof(label), "%s Key %u", fieldName, entry);
+        uint8_t *key = keys.ptr;
+        parsePublicKeyField(&keys, label, arg);
+        appendWeight(&keys, arg);
+        appendOwnKey(key, arg);
+    }
+    return true;
 }
 
-void parseStringField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written) {
-    uint32_t labelLength = strlen(fieldName);
-    if (labelLength > sizeof(arg->label)) {
-        PRINTF("parseActionData Label too long\n");
-        THROW(EXCEPTION);
+/**
+ * Authority left unchanged when absent, then reviewed on a single page.
+*/
+bool parseOptionalAuthorityPages(cursor_t *cursor, const char fieldName[], uint8_t *page, uint8_t argNum, actionArgument_t *arg) {
+    if (cursor_read_u8(cursor) == 0x00) {
+        if (argNum == (*page)++) {
+            printString("Unchanged", fieldName, arg);
+            return true;
+        }
+        return false;
     }
+    return parseAuthorityPages(cursor, fieldName, page, argNum, arg);
+}
 
-    os_memset(arg->label, 0, sizeof(arg->label));
-    os_memset(arg->data, 0, sizeof(arg->data));
-
-    os_memmove(arg->label, fieldName, labelLength);
+// room kept in a JSON page label for the page number
+#define JSON_LABEL_SUFFIX 8
 
-    uint32_t fieldLength = 0;
-    uint32_t readFromBuffer = unpack_variant32(in, inLength, &fieldLength);
-    if (fieldLength > sizeof(arg->data) - 1) {
-        PRINTF("parseActionData Insufficient bufferg\n");
-        THROW(EXCEPTION);
-    } 
+static const char *layoutLabel(const jsonLayout_t *layout, const jsonValue_t *value) {
+    const jsonField_t *fields;
+    uint8_t i;
 
-    if (inLength < fieldLength) {
-        PRINTF("parseActionData Insufficient buffer\n");
-        THROW(EXCEPTION);
+    if (value->name == NULL) {
+        return NULL;
     }
+    fields = (const jsonField_t *)PIC(layout->fields);
+    for (i = 0; i < layout->fieldCount; ++i) {
+        const char *key = (const char *)PIC(fields[i].key);
+        if (strlen(key) == value->nameLength && memcmp(key, value->name, value->nameLength) == 0) {
+            return (const char *)PIC(fields[i].label);
+        }
+    }
+    return NULL;
+}
 
-    in += readFromBuffer;
-    inLength -= readFromBuffer;
-
-    os_memmove(arg->data, in, fieldLength);
+/**
+ * Put text in front of the label built backwards from label + *start, or
+ * its end behind ".." when it does not fit. Keys are displayed as JSON
+ * strings. Returns false once the label is full.
+*/
+static bool prependPath(char *label, uint8_t *start, const char *text, uint32_t length, bool key) {
+    uint32_t total = key ? json_display_string((const uint8_t *)text, length, 0, NULL, 0) : length;
+    uint32_t count = total;
+    bool fits = total <= *start;
+
+    if (!fits) {
+        count = *start > 2 ? *start - 2 : 0;
+    }
+    if (key) {
+        json_display_string((const uint8_t *)text, length, total - count, label + *start - count, count);
+    } else {
+        os_memmove(label + *start - count, text + total - count, count);
+    }
+    *start -= count;
+    if (!fits) {
+        label[0] = '.';
+        label[1] = '.';
+        *start = 0;
+    }
+    return fits;
+}
 
-    in += fieldLength;
-    inLength -= fieldLength;
+/**
+ * Label of the value just read, its path from the root of the document
+ * such as payload.to or items[2].to, shortened from the left to fit. The
+ * key of the value takes its layout label, and the path of an action
+ * payload starts with its keys.
+*/
+static void jsonPathLabel(const jsonTokenizer_t *tokenizer, const char fieldName[], const char *known,
+                          bool action, char *label, uint8_t size) {
+    char index[8];
+    uint8_t start = size - 1 - JSON_LABEL_SUFFIX;
+    uint8_t end = start;
+    bool more = true;
+    uint8_t i;
+
+    label[start] = '\0';
+    for (i = tokenizer->depth; i-- > 0 && more;) {
+        const jsonLevel_t *level = &tokenizer->levels[i];
+
+        if (level->type == '[' && action && i == 0) {
+            continue;
+        }
+        // keys are separated from what follows them
+        if (start != end && label[start] != '[') {
+            more = prependPath(label, &start, ".", 1, false);
+        }
+        if (!more) {
+            break;
+        }
+        if (level->type == '[') {
+            snprintf(index, sizeof(index), "[%u]", level->index);
+            more = prependPath(label, &start, index, strlen(index), false);
+        } else if (known != NULL) {
+            // only the innermost key takes the layout label
+            more = prependPath(label, &start, known, strlen(known), false);
+            known = NULL;
+        } else {
+            more = prependPath(label, &start, (const char *)level->name, level->nameLength, true);
+        }
+    }
+    if (more && (tokenizer->depth == 0 || (tokenizer->levels[0].type == '[' && !action))) {
+        prependPath(label, &start, fieldName, strlen(fieldName), false);
+    }
+    os_memmove(label, label + start, end - start + 1);
+}
 
-    *read = readFromBuffer + fieldLength;
-    *written = fieldLength;
+/**
+ * A JSON document is reviewed one page per value, in document order,
+ * labelled with the path of its keys and array indexes. Values longer
+ * than a page are split across several. Strings are displayed with
+ * json_display_string, so that only printable ASCII reaches the screen.
+ * With a known layout, listed keys take its labels instead.
+ * The tokenizer reads the document in place, so only the displayed value
+ * is copied.
+ * Returns true when page argNum belongs to the document and has been
+ * printed, otherwise moves *page past the document.
+*/
+bool parseJsonPages(cursor_t *cursor, const char fieldName[], const jsonLayout_t *layout,
+                    uint8_t *page, uint8_t argNum, actionArgument_t *arg) {
+    char label[sizeof(arg->label)];
+    jsonTokenizer_t tokenizer;
+    jsonValue_t value;
+    uint32_t length = cursor_read_varint(cursor);
+    uint32_t pageLength = sizeof(arg->data) - 1;
+
+    json_init(&tokenizer, cursor_read_bytes(cursor, length), length);
+    while (json_next_value(&tokenizer, &value)) {
+        uint32_t displayLength = value.isString ? json_display_string(value.data, value.length, 0, NULL, 0) : value.length;
+        uint32_t parts = displayLength == 0 ? 1 : (displayLength + pageLength - 1) / pageLength;
+        uint32_t part;
+        bool action;
+
+        if (*page + parts > MAX_ARGUMENT_COUNT) {
+            THROW(EXCEPTION_OVERFLOW);
+        }
+        if (argNum < *page || argNum - *page >= parts) {
+            *page += parts;
+            continue;
+        }
+
+        part = argNum - *page;
+        // ["name", {...}]
+        action = layout != NULL && value.depth >= 1 && tokenizer.levels[0].type == '[';
+        if (action && value.depth == 1 && value.index == 0) {
+            strcpy(label, "Action");
+        } else {
+            jsonPathLabel(&tokenizer, fieldName, layout != NULL ? layoutLabel(layout, &value) : NULL,
+                          action && tokenizer.levels[0].index == 1, label, sizeof(label));
+        }
+        if (parts > 1) {
+            snprintf(label + strlen(label), sizeof(label) - strlen(label), " (%u/%u)", part + 1, parts);
+        }
+        setLabel(label, arg);
+
+        length = displayLength - part * pageLength;
+        if (length > pageLength) {
+            length = pageLength;
+        }
+        if (value.isString) {
+            json_display_string(value.data, value.length, part * pageLength, arg->data, length);
+        } else {
+            os_memmove(arg->data, value.data + part * pageLength, length);
+        }
+        arg->data[length] = '\0';
+        return true;
+    }
+    return false;
 }
@@ -19,6 +19,17 @@
 #define __HIVE_PARSE_H__
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "hive_cursor.h"
+#include "hive_json.h"
+
+// review pages of a single operation
+#define MAX_ARGUMENT_COUNT 64
+
+// asks a paged decoder for its page count
+#define ARGUMENT_COUNT_QUERY 0xFF
+// past every argument, decoders then check all the fields
+#define ARGUMENT_VALIDATE 0xFE
 
 typedef struct actionArgument_t {
     char label[32];
@@ -26,12 +37,19 @@ typedef struct actionArgument_t {
 } actionArgument_t;
 
 void printString(const char in[], const char fieldName[], actionArgument_t *arg);
-void parsePublicKeyField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
-void parseUint16Field(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
-void parseUint32Field(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
-void parseInt64Field(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
-void parseUInt64Field(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
-void parseAssetField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
-void parseStringField(uint8_t *in, uint32_t inLength, const char fieldName[], actionArgument_t *arg, uint32_t *read, uint32_t *written);
+void parsePublicKeyField(cursor_t *cursor, const char fieldName[], actionArgument_t *arg);
+void parseUint16Field(cursor_t *cursor, const char fieldName[], actionArgument_t *arg);
+void parseUint32Field(cursor_t *cursor, const char fieldName[], actionArgument_t *arg);
+void parseInt64Field(cursor_t *cursor, const char fieldName[], actionArgument_t *arg);
+void parseUInt64Field(cursor_t *cursor, const char fieldName[], actionArgument_t *arg);
+void parseAssetField(cursor_t *cursor, const char fieldName[], actionArgument_t *arg);
+void parseStringField(cursor_t *cursor, const char fieldName[], actionArgument_t *arg);
+void parseRecipientField(cursor_t *cursor, const char fieldName[], actionArgument_t *arg);
+void parseBoolField(cursor_t *cursor, const char fieldName[], actionArgument_t *arg);
+void appendOwnKey(const uint8_t *key, actionArgument_t *arg);
+bool parseAuthorityPages(cursor_t *cursor, const char fieldName[], uint8_t *page, uint8_t argNum, actionArgument_t *arg);
+bool parseOptionalAuthorityPages(cursor_t *cursor, const char fieldName[], uint8_t *page, uint8_t argNum, actionArgument_t *arg);
+bool parseJsonPages(cursor_t *cursor, const char fieldName[], const jsonLayout_t *layout,
+                    uint8_t *page, uint8_t argNum, actionArgument_t *arg);
 
 #endif
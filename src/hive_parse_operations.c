@@ -16,1309 +16,863 @@
 ********************************************************************************/
 
 #include "hive_parse_operations.h"
+#include "hive_cursor.h"
 #include "hive_types.h"
+#include "hive_custom_json.h"
 #include <string.h>
 #include "os.h"
 
-void parseHiveVote(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
+/**
+ * Operations are stored with their type, skip it before reading fields.
+*/
+static void initOperationCursor(cursor_t *cursor, uint8_t *buffer, uint32_t bufferLength) {
+    cursor_init(cursor, buffer, bufferLength);
+    cursor_read_varint(cursor);
+}
+
+/**
+ * Reached past the last field: the operation must end there, after an
+ * empty extension list for the operations that have one.
+*/
+static void endOperation(cursor_t *cursor, bool extensions) {
+    if (extensions && cursor_read_varint(cursor) != 0) {
+        PRINTF("Unsupported operation extension\n");
+        THROW(EXCEPTION);
+    }
+    if (cursor_remaining(cursor) != 0) {
+        PRINTF("Trailing operation data\n");
+        THROW(EXCEPTION);
+    }
+}
+
+#if defined(HAVE_HIVE_OP_CUSTOM_JSON)
+static void parseAccountListField(cursor_t *cursor, const char fieldName[], actionArgument_t *arg) {
+    char tmp[sizeof(arg->data)];
+    uint32_t count = cursor_read_varint(cursor);
+
+    snprintf(tmp, sizeof(tmp), "[ ");
+    for (uint32_t i = 0; i < count; ++i) {
+        parseStringField(cursor, fieldName, arg);
+        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), i == count-1 ? "%s" : "%s, ", arg->data);
+    }
+    snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), " ]");
 
-    buffer++; // opType byte
+    printString(tmp, fieldName, arg);
+}
+#endif
 
-    parseStringField(buffer, bufferLength, "Voter", arg, &read, &written);
+#if defined(HAVE_HIVE_OP_UPDATE_PROPOSAL_VOTES) || defined(HAVE_HIVE_OP_REMOVE_PROPOSAL)
+static void parseProposalIdsField(cursor_t *cursor, const char fieldName[], actionArgument_t *arg) {
+    char tmp[sizeof(arg->data)];
+    uint32_t count = cursor_read_varint(cursor);
+
+    snprintf(tmp, sizeof(tmp), "[ ");
+    for (uint32_t i = 0; i < count; ++i) {
+        parseInt64Field(cursor, fieldName, arg);
+        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), i == count-1 ? "%s" : "%s, ", arg->data);
+    }
+    snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), " ]");
+
+    printString(tmp, fieldName, arg);
+}
+#endif
+
+#if defined(HAVE_HIVE_OP_ACCOUNT_CREATE) || defined(HAVE_HIVE_OP_ACCOUNT_UPDATE) || defined(HAVE_HIVE_OP_CREATE_CLAIMED_ACCOUNT)
+/**
+ * Memo key of the account operations, past variable authority pages.
+ * The key is only converted when it is displayed.
+*/
+static bool parseMemoKeyPage(cursor_t *cursor, uint8_t *page, uint8_t argNum, actionArgument_t *arg) {
+    if (argNum == (*page)++) {
+        uint8_t *key = cursor->ptr;
+        parsePublicKeyField(cursor, "Memo Key", arg);
+        appendOwnKey(key, arg);
+        return true;
+    }
+    cursor_skip(cursor, sizeof(public_key_t));
+    return false;
+}
+#endif
+
+#ifdef HAVE_HIVE_OP_VOTE
+void parseHiveVote(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
+
+    parseStringField(&cursor, "Voter", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "Author", arg, &read, &written);
+    parseStringField(&cursor, "Author", arg);
     if (argNum == 1) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "Permlink", arg, &read, &written);
+    parseStringField(&cursor, "Permlink", arg);
     if (argNum == 2) return;
 
-    buffer += read; bufferLength -= read;
-    parseUint16Field(buffer, bufferLength, "Weight", arg, &read, &written);
+    parseUint16Field(&cursor, "Weight", arg);
+
+    endOperation(&cursor, false);
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_COMMENT
 void parseHiveComment(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    buffer++; // opType byte
-
-    parseStringField(buffer, bufferLength, "Parent Author", arg, &read, &written);
+    parseStringField(&cursor, "Parent Author", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "Parent Permlink", arg, &read, &written);
+    parseStringField(&cursor, "Parent Permlink", arg);
     if (argNum == 1) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "Author", arg, &read, &written);
+    parseStringField(&cursor, "Author", arg);
     if (argNum == 2) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "Permlink", arg, &read, &written);
+    parseStringField(&cursor, "Permlink", arg);
     if (argNum == 3) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "Title", arg, &read, &written);
+    parseStringField(&cursor, "Title", arg);
     if (argNum == 4) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "Body", arg, &read, &written);
+    parseStringField(&cursor, "Body", arg);
     if (argNum == 5) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "JSON Metadata", arg, &read, &written);
+    parseStringField(&cursor, "JSON Metadata", arg);
+
+    endOperation(&cursor, false);
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_TRANSFER
 void parseHiveTransfer(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    buffer++; // opType byte
-
-    parseStringField(buffer, bufferLength, "From", arg, &read, &written);
+    parseStringField(&cursor, "From", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "To", arg, &read, &written);
+    parseRecipientField(&cursor, "To", arg);
     if (argNum == 1) return;
 
-    buffer += read; bufferLength -= read;
-    parseAssetField(buffer, sizeof(asset_t), "Amount", arg, &read, &written);
+    parseAssetField(&cursor, "Amount", arg);
     if (argNum == 2) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "Memo", arg, &read, &written);
+    parseStringField(&cursor, "Memo", arg);
+
+    endOperation(&cursor, false);
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_TRANSFER_TO_VESTING
 void parseHiveTransferToVesting(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    buffer++; // opType byte
-
-    parseStringField(buffer, bufferLength, "From", arg, &read, &written);
+    parseStringField(&cursor, "From", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "To", arg, &read, &written);
+    parseRecipientField(&cursor, "To", arg);
     if (argNum == 1) return;
 
-    buffer += read; bufferLength -= read;
-    parseAssetField(buffer, sizeof(asset_t), "Amount", arg, &read, &written);
+    parseAssetField(&cursor, "Amount", arg);
+
+    endOperation(&cursor, false);
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_WITHDRAW_VESTING
 void parseHiveWithdrawVesting(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    buffer++; // opType byte
-
-    parseStringField(buffer, bufferLength, "Account", arg, &read, &written);
+    parseStringField(&cursor, "Account", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseAssetField(buffer, sizeof(asset_t), "Vesting Shares", arg, &read, &written);
+    parseAssetField(&cursor, "Vesting Shares", arg);
+
+    endOperation(&cursor, false);
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_LIMIT_ORDER_CREATE
 void parseHiveLimitOrderCreate(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    buffer++; // opType byte
-
-    parseStringField(buffer, bufferLength, "Owner", arg, &read, &written);
+    parseStringField(&cursor, "Owner", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseUint32Field(buffer, bufferLength, "Order ID", arg, &read, &written);
+    parseUint32Field(&cursor, "Order ID", arg);
     if (argNum == 1) return;
 
-    buffer += sizeof(uint32_t); bufferLength -= sizeof(uint32_t);
-    parseAssetField(buffer, sizeof(asset_t), "Amount To Sell", arg, &read, &written);
+    parseAssetField(&cursor, "Amount To Sell", arg);
     if (argNum == 2) return;
 
-    buffer += read; bufferLength -= read;
-    parseAssetField(buffer, sizeof(asset_t), "Min To Receive", arg, &read, &written);
+    parseAssetField(&cursor, "Min To Receive", arg);
     if (argNum == 3) return;
 
-    buffer += read; bufferLength -= read;
-    printString(buffer[0] == 0x01 ? "true" : "false", "Fill or Kill", arg);
+    parseBoolField(&cursor, "Fill or Kill", arg);
     if (argNum == 4) return;
 
-    buffer += read; bufferLength -= read;
-    parseUint32Field(buffer, bufferLength, "Expiration", arg, &read, &written);
+    parseUint32Field(&cursor, "Expiration", arg);
+
+    endOperation(&cursor, false);
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_LIMIT_ORDER_CANCEL
 void parseHiveLimitOrderCancel(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    buffer++; // opType byte
-
-    parseStringField(buffer, bufferLength, "Owner", arg, &read, &written);
+    parseStringField(&cursor, "Owner", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseUint32Field(buffer, bufferLength, "Order ID", arg, &read, &written);
+    parseUint32Field(&cursor, "Order ID", arg);
+
+    endOperation(&cursor, false);
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_FEED_PUBLISH
 void parseHiveFeedPublish(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    buffer++; // opType byte
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    parseStringField(buffer, bufferLength, "Publisher", arg, &read, &written);
+    parseStringField(&cursor, "Publisher", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseAssetField(buffer, bufferLength, "Base", arg, &read, &written);
+    parseAssetField(&cursor, "Base", arg);
     if (argNum == 1) return;
 
-    buffer += read; bufferLength -= read;
-    parseAssetField(buffer, bufferLength, "Quote", arg, &read, &written);
-}
-
-void parseHiveConvert(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    buffer++; // opType byte
-
-    parseStringField(buffer, bufferLength, "Owner", arg, &read, &written);
-    if (argNum == 0) return;
-
-    buffer += read; bufferLength -= read;
-    parseUint32Field(buffer, bufferLength, "Request ID", arg, &read, &written);
-    if (argNum == 1) return;
+    parseAssetField(&cursor, "Quote", arg);
 
-    buffer += read; bufferLength -= read;
-    parseAssetField(buffer, sizeof(asset_t), "Amount", arg, &read, &written);
+    endOperation(&cursor, false);
 }
+#endif
 
-void parseHiveAccountCreate(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    buffer++; // opType byte
+#ifdef HAVE_HIVE_OP_CONVERT
+void parseHiveConvert(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    parseAssetField(buffer, sizeof(asset_t), "Amount", arg, &read, &written);
+    parseStringField(&cursor, "Owner", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, sizeof(asset_t), "Creator", arg, &read, &written);
+    parseUint32Field(&cursor, "Request ID", arg);
     if (argNum == 1) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, sizeof(asset_t), "New Account Name", arg, &read, &written);
-    if (argNum == 2) return;
-
-    char tmp[128];
-
-    parseUint32Field(buffer, bufferLength, "Owner Auth", arg, &read, &written);
-    buffer += read; bufferLength -= read;
-
-    snprintf(tmp, sizeof(tmp), "Weight: %s - ", arg->data);
-    os_memset(arg->data, 0, sizeof(arg->data));
-
-    uint8_t numOwnerAccountAuths = 0;
-    os_memmove(&numOwnerAccountAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numOwnerAccountAuths; ++i) {
-        parseStringField(buffer, bufferLength, "Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "A%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    uint8_t numOwnerKeyAuths = 0;
-    os_memmove(&numOwnerKeyAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numOwnerKeyAuths; ++i) {
-        parsePublicKeyField(buffer, bufferLength, "Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "K%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    if( argNum == 2) { // owner auth
-        os_memset(arg->data, 0, sizeof(arg->data));
-        os_memmove(arg->data, tmp, sizeof(tmp));
-        return;
-    }
-
-    os_memset(tmp, 0, sizeof(tmp));
-
-    parseUint32Field(buffer, bufferLength, "Active Auth", arg, &read, &written);
-    buffer += read; bufferLength -= read;
-
-    snprintf(tmp, sizeof(tmp), "Weight: %s - ", arg->data);
-    os_memset(arg->data, 0, sizeof(arg->data));
-
-    uint8_t numActiveAccountAuths = 0;
-    os_memmove(&numActiveAccountAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numActiveAccountAuths; ++i) {
-        parseStringField(buffer, bufferLength, "Active Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "K%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "Active Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    uint8_t numActiveKeyAuths = 0;
-    os_memmove(&numActiveKeyAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numActiveKeyAuths; ++i) {
-        parsePublicKeyField(buffer, bufferLength, "Active Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "K%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "Active Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    if( argNum == 3) { // active auth
-        os_memset(arg->data, 0, sizeof(arg->data));
-        os_memmove(arg->data, tmp, sizeof(tmp));
-        return;
-    }
-
-    os_memset(tmp, 0, sizeof(tmp));
-    os_memset(arg->data, 0, sizeof(arg->data));
-
-    parseUint32Field(buffer, bufferLength, "Posting Auth", arg, &read, &written);
-    buffer += read; bufferLength -= read;
-
-    snprintf(tmp, sizeof(tmp), "Weight: %s - ", arg->data);
-    os_memset(arg->data, 0, sizeof(arg->data));
-
-    uint8_t numPostingAccountAuths = 0;
-    os_memmove(&numPostingAccountAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numPostingAccountAuths; ++i) {
-        parseStringField(buffer, bufferLength, "Posting Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "A%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "Posting Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    uint8_t numPostingKeyAuths = 0;
-    os_memmove(&numPostingKeyAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numPostingKeyAuths; ++i) {
-        parsePublicKeyField(buffer, bufferLength, "Posting Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "K%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "Posting Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    if( argNum == 4) { // posting auth
-        os_memset(arg->data, 0, sizeof(arg->data));
-        os_memmove(arg->data, tmp, sizeof(tmp));
-        return;
-    }
-
-    os_memset(arg->data, 0, sizeof(arg->data));
-
-    parsePublicKeyField(buffer, bufferLength, "Memo Key", arg, &read, &written);
-    buffer += read; bufferLength -= read;
+    parseAssetField(&cursor, "Amount", arg);
 
-    if( argNum == 5) return;
-
-    os_memset(arg->data, 0, sizeof(arg->data));
-
-    parseStringField(buffer, bufferLength, "JSON Metadata", arg, &read, &written);
+    endOperation(&cursor, false);
 }
+#endif
 
-void parseHiveAccountUpdate(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    buffer++; // opType byte
-
-    parseStringField(buffer, sizeof(asset_t), "Account", arg, &read, &written);
-    if (argNum == 2) return;
-
-    char tmp[128];
-
-    parseUint32Field(buffer, bufferLength, "Owner Auth", arg, &read, &written);
-    buffer += read; bufferLength -= read;
-
-    snprintf(tmp, sizeof(tmp), "Weight: %s - ", arg->data);
-    os_memset(arg->data, 0, sizeof(arg->data));
-
-    uint8_t numOwnerAccountAuths = 0;
-    os_memmove(&numOwnerAccountAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numOwnerAccountAuths; ++i) {
-        parseStringField(buffer, bufferLength, "Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "A%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    uint8_t numOwnerKeyAuths = 0;
-    os_memmove(&numOwnerKeyAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numOwnerKeyAuths; ++i) {
-        parsePublicKeyField(buffer, bufferLength, "Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "K%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    if( argNum == 2) { // owner auth
-        os_memset(arg->data, 0, sizeof(arg->data));
-        os_memmove(arg->data, tmp, sizeof(tmp));
-        return;
-    }
-
-    os_memset(tmp, 0, sizeof(tmp));
-
-    parseUint32Field(buffer, bufferLength, "Active Auth", arg, &read, &written);
-    buffer += read; bufferLength -= read;
-
-    snprintf(tmp, sizeof(tmp), "Weight: %s - ", arg->data);
-    os_memset(arg->data, 0, sizeof(arg->data));
-
-    uint8_t numActiveAccountAuths = 0;
-    os_memmove(&numActiveAccountAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numActiveAccountAuths; ++i) {
-        parseStringField(buffer, bufferLength, "Active Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "K%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "Active Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
+#ifdef HAVE_HIVE_OP_ACCOUNT_CREATE
+uint8_t parseHiveAccountCreate(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
+    cursor_t cursor;
+    uint8_t page = 3;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    uint8_t numActiveKeyAuths = 0;
-    os_memmove(&numActiveKeyAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numActiveKeyAuths; ++i) {
-        parsePublicKeyField(buffer, bufferLength, "Active Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "K%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "Active Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
+    parseAssetField(&cursor, "Amount", arg);
+    if (argNum == 0) return 0;
 
-    if( argNum == 3) { // active auth
-        os_memset(arg->data, 0, sizeof(arg->data));
-        os_memmove(arg->data, tmp, sizeof(tmp));
-        return;
-    }
+    parseStringField(&cursor, "Creator", arg);
+    if (argNum == 1) return 0;
 
-    os_memset(tmp, 0, sizeof(tmp));
-    os_memset(arg->data, 0, sizeof(arg->data));
+    parseStringField(&cursor, "New Account Name", arg);
+    if (argNum == 2) return 0;
 
-    parseUint32Field(buffer, bufferLength, "Posting Auth", arg, &read, &written);
-    buffer += read; bufferLength -= read;
+    if (parseAuthorityPages(&cursor, "Owner Auth", &page, argNum, arg)) return 0;
+    if (parseAuthorityPages(&cursor, "Active Auth", &page, argNum, arg)) return 0;
+    if (parseAuthorityPages(&cursor, "Posting Auth", &page, argNum, arg)) return 0;
 
-    snprintf(tmp, sizeof(tmp), "Weight: %s - ", arg->data);
-    os_memset(arg->data, 0, sizeof(arg->data));
+    if (parseMemoKeyPage(&cursor, &page, argNum, arg)) return 0;
 
-    uint8_t numPostingAccountAuths = 0;
-    os_memmove(&numPostingAccountAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
+    parseStringField(&cursor, "JSON Metadata", arg);
+    if (argNum == page++) return 0;
 
-    for (uint8_t i = 0; i < numPostingAccountAuths; ++i) {
-        parseStringField(buffer, bufferLength, "Posting Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "A%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "Posting Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    uint8_t numPostingKeyAuths = 0;
-    os_memmove(&numPostingKeyAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numPostingKeyAuths; ++i) {
-        parsePublicKeyField(buffer, bufferLength, "Posting Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "K%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "Posting Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    if( argNum == 4) { // posting auth
-        os_memset(arg->data, 0, sizeof(arg->data));
-        os_memmove(arg->data, tmp, sizeof(tmp));
-        return;
-    }
+    endOperation(&cursor, false);
+    return page;
+}
+#endif
 
-    os_memset(arg->data, 0, sizeof(arg->data));
+#ifdef HAVE_HIVE_OP_ACCOUNT_UPDATE
+uint8_t parseHiveAccountUpdate(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
+    cursor_t cursor;
+    uint8_t page = 1;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    parsePublicKeyField(buffer, bufferLength, "Memo Key", arg, &read, &written);
-    buffer += read; bufferLength -= read;
+    parseStringField(&cursor, "Account", arg);
+    if (argNum == 0) return 0;
 
-    if( argNum == 5) return;
+    if (parseOptionalAuthorityPages(&cursor, "Owner Auth", &page, argNum, arg)) return 0;
+    if (parseOptionalAuthorityPages(&cursor, "Active Auth", &page, argNum, arg)) return 0;
+    if (parseOptionalAuthorityPages(&cursor, "Posting Auth", &page, argNum, arg)) return 0;
 
-    os_memset(arg->data, 0, sizeof(arg->data));
+    if (parseMemoKeyPage(&cursor, &page, argNum, arg)) return 0;
 
-    parseStringField(buffer, bufferLength, "JSON Metadata", arg, &read, &written);
+    parseStringField(&cursor, "JSON Metadata", arg);
+    if (argNum == page++) return 0;
 
+    endOperation(&cursor, false);
+    return page;
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_WITNESS_UPDATE
 void parseHiveWitnessUpdate(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    buffer++; // opType byte
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    parseStringField(buffer, bufferLength, "Owner", arg, &read, &written);
+    parseStringField(&cursor, "Owner", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "URL", arg, &read, &written);
+    parseStringField(&cursor, "URL", arg);
     if (argNum == 1) return;
 
-    buffer += read; bufferLength -= read;
-    parsePublicKeyField(buffer, bufferLength, "Signing Key", arg, &read, &written);
+    parsePublicKeyField(&cursor, "Signing Key", arg);
     if (argNum == 2) return;
 
-    buffer += read; bufferLength -= read;
-
     // props
-    char tmp[128];
-
-    snprintf(tmp, sizeof(tmp), "Account Creation Fee: ");
+    char tmp[sizeof(arg->data)];
 
-    parseAssetField(buffer, sizeof(asset_t), "Witness Props", arg, &read, &written);
-    buffer += read; bufferLength -= read;
-    snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s", arg->data);
+    parseAssetField(&cursor, "Witness Props", arg);
+    snprintf(tmp, sizeof(tmp), "Account Creation Fee: %s", arg->data);
 
-    snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), " - Max Block Size: ");
+    parseUint32Field(&cursor, "Witness Props", arg);
+    snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), " - Max Block Size: %s", arg->data);
 
-    parseUint32Field(buffer, sizeof(asset_t), "Witness Props", arg, &read, &written);
-    buffer += read; bufferLength -= read;
-    snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s", arg->data);
+    parseUint16Field(&cursor, "Witness Props", arg);
+    snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), " - HBD Interest Rate: %s", arg->data);
 
-    snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), " - HBD Interest Rate: ");
+    if (argNum == 3) {
+        printString(tmp, "Witness Props", arg);
+        return;
+    }
 
-    parseUint16Field(buffer, sizeof(asset_t), "Witness Props", arg, &read, &written);
-    snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s", arg->data);
+    parseAssetField(&cursor, "Fee", arg);
 
-    os_memset(arg->data, 0, sizeof(arg->data));
-    os_memmove(arg->data, tmp, sizeof(tmp));
+    endOperation(&cursor, false);
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_ACCOUNT_WITNESS_VOTE
 void parseHiveAccountWitnessVote(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    buffer++; // opType byte
-
-    parseStringField(buffer, bufferLength, "Account", arg, &read, &written);
+    parseStringField(&cursor, "Account", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "Witness", arg, &read, &written);
+    parseStringField(&cursor, "Witness", arg);
     if (argNum == 1) return;
 
-    buffer += read; bufferLength -= read;
-    printString(buffer[0] == 0x01 ? "true" : "false", "Approve", arg);
+    parseBoolField(&cursor, "Approve", arg);
+
+    endOperation(&cursor, false);
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_ACCOUNT_WITNESS_PROXY
 void parseHiveAccountWitnessProxy(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    buffer++; // opType byte
-
-    parseStringField(buffer, bufferLength, "Account", arg, &read, &written);
+    parseStringField(&cursor, "Account", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "Proxy", arg, &read, &written);
+    parseStringField(&cursor, "Proxy", arg);
+
+    endOperation(&cursor, false);
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_DELETE_COMMENT
 void parseHiveDeleteComment(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    buffer++; // opType byte
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    parseStringField(buffer, bufferLength, "Author", arg, &read, &written);
+    parseStringField(&cursor, "Author", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "Permlink", arg, &read, &written);
-}
-
-void parseHiveCustomJson(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    buffer++; // opType byte
-
-    char tmp[128];
-
-    uint32_t requiredAuths = 0;
-    read = unpack_variant32(buffer, sizeof(uint32_t), &requiredAuths);
-    buffer += read; bufferLength -= read;
-
-    snprintf(tmp, sizeof(tmp), "[ ");
-
-    for(uint32_t i = 0; i < requiredAuths; ++i) {
-        parseStringField(buffer, bufferLength, "Required Auths", arg, &read, &written);
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), i == requiredAuths-1 ? "%s" : "%s, ", arg->data);
-        buffer += read; bufferLength -= read;
-    }
-
-    snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), " ]");
-
-    if (argNum == 0) {
-        os_memset(arg->data, 0, sizeof(arg->data));
-        os_memmove(arg->data, tmp, sizeof(tmp));
-        return;
-    }
+    parseStringField(&cursor, "Permlink", arg);
 
-    uint32_t requiredPostingAuths = 0;
-    read = unpack_variant32(buffer, sizeof(uint32_t), &requiredPostingAuths);
-    buffer += read; bufferLength -= read;
+    endOperation(&cursor, false);
+}
+#endif
 
-    snprintf(tmp, sizeof(tmp), "[ ");
+#ifdef HAVE_HIVE_OP_CUSTOM_JSON
+/**
+ * Well-known ids are named on the ID page and their payload reviewed with
+ * the labels of their layout.
+*/
+uint8_t parseHiveCustomJson(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
+    cursor_t cursor;
+    uint8_t page = 3;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    for(uint32_t i = 0; i < requiredPostingAuths; ++i) {
-        parseStringField(buffer, bufferLength, "Required Auths", arg, &read, &written);
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), i == requiredPostingAuths-1 ? "%s" : "%s, ", arg->data);
-        buffer += read; bufferLength -= read;
-    }
+    parseAccountListField(&cursor, "Required Auths", arg);
+    if (argNum == 0) return 0;
 
-    snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), " ]");
+    parseAccountListField(&cursor, "Required Posting Auths", arg);
+    if (argNum == 1) return 0;
 
-    if (argNum == 1) {
-        os_memset(arg->data, 0, sizeof(arg->data));
-        os_memmove(arg->data, tmp, sizeof(tmp));
-        return;
+    cursor_t id = cursor;
+    uint32_t idLength = cursor_read_varint(&id);
+    parseStringField(&cursor, "ID", arg);
+    const customJsonId_t *known = hive_custom_json_find(id.ptr, idLength);
+    if (argNum == 2) {
+        if (known != NULL) {
+            snprintf(arg->data + strlen(arg->data), sizeof(arg->data) - strlen(arg->data),
+                     " (%s)", (const char *)PIC(known->name));
+        }
+        return 0;
     }
 
-    parseStringField(buffer, bufferLength, "ID", arg, &read, &written);
-    if (argNum == 2) return;
+    if (parseJsonPages(&cursor, "JSON", known != NULL ? &known->layout : NULL, &page, argNum, arg)) return 0;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "JSON", arg, &read, &written);
+    endOperation(&cursor, false);
+    return page;
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_COMMENT_OPTIONS
 void parseHiveCommentOptions(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    buffer++; // opType byte
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    parseStringField(buffer, bufferLength, "Author", arg, &read, &written);
+    parseStringField(&cursor, "Author", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "Permlink", arg, &read, &written);
+    parseStringField(&cursor, "Permlink", arg);
     if (argNum == 1) return;
 
-    buffer += read; bufferLength -= read;
-    parseAssetField(buffer, bufferLength, "Max Payout", arg, &read, &written);
+    parseAssetField(&cursor, "Max Payout", arg);
     if (argNum == 2) return;
 
-    buffer += read; bufferLength -= read;
-    parseUint16Field(buffer, bufferLength, "Percent HBD", arg, &read, &written);
+    parseUint16Field(&cursor, "Percent HBD", arg);
     if (argNum == 3) return;
 
-    buffer += read; bufferLength -= read;
-    printString(buffer[0] == 0x01 ? "true" : "false", "Allow Votes", arg);
+    parseBoolField(&cursor, "Allow Votes", arg);
     if (argNum == 4) return;
 
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-    printString(buffer[0] == 0x01 ? "true" : "false", "Allow Curation Rewards", arg);
+    parseBoolField(&cursor, "Allow Curation Rewards", arg);
     if (argNum == 5) return;
 
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    uint8_t numExtensions = 0;
-    os_memmove(&numExtensions, buffer, sizeof(uint8_t));
+    uint32_t numExtensions = cursor_read_varint(&cursor);
 
     if(numExtensions == 0) {
         printString("[]", "Beneficiaries", arg);
+        endOperation(&cursor, false);
         return;
     } else if (numExtensions > 1) {
         THROW(EXCEPTION);
     }
 
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    if(buffer[0] != 0x00) THROW(EXCEPTION); // only beneficiaries (0x00) are implemented
+    if(cursor_read_varint(&cursor) != 0x00) THROW(EXCEPTION); // only beneficiaries (0x00) are implemented
 
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
+    char tmp[sizeof(arg->data)];
 
-    char tmp[128];
-
-    uint8_t numBeneficiaries = 0;
-    os_memmove(&numBeneficiaries, buffer, sizeof(uint8_t));
-
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
+    uint32_t numBeneficiaries = cursor_read_varint(&cursor);
 
     snprintf(tmp, sizeof(tmp), "[ ");
 
-    for(uint8_t i = 0; i < numBeneficiaries; ++i) {
-        parseStringField(buffer, bufferLength, "Beneficiaries", arg, &read, &written);
-        buffer += read; bufferLength -= read;
+    for(uint32_t i = 0; i < numBeneficiaries; ++i) {
+        parseStringField(&cursor, "Beneficiaries", arg);
         snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s - ", arg->data);
-        parseUint16Field(buffer, bufferLength, "Beneficiaries", arg, &read, &written);
-        buffer += read; bufferLength -= read;
+        parseUint16Field(&cursor, "Beneficiaries", arg);
         snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), i == numBeneficiaries-1 ? "%s" : "%s, ", arg->data);
     }
 
     snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), " ]");
 
-    os_memset(arg->data, 0, sizeof(arg->data));
-    os_memmove(arg->data, tmp, sizeof(tmp));
+    printString(tmp, "Beneficiaries", arg);
+
+    endOperation(&cursor, false);
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_SET_WITHDRAW_VESTING_ROUTE
 void parseHiveSetWithdrawVestingRoute(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    buffer++; // opType byte
-
-    parseStringField(buffer, bufferLength, "From Account", arg, &read, &written);
+    parseStringField(&cursor, "From Account", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "To Account", arg, &read, &written);
+    parseStringField(&cursor, "To Account", arg);
     if (argNum == 1) return;
 
-    buffer += read; bufferLength -= read;
-    parseUint32Field(buffer, bufferLength, "Percent", arg, &read, &written);
+    parseUint16Field(&cursor, "Percent", arg);
     if (argNum == 2) return;
 
-    buffer += read; bufferLength -= read;
-    printString(buffer[0] == 0x01 ? "true" : "false", "Autovest", arg);
-}
+    parseBoolField(&cursor, "Autovest", arg);
 
-void parseHiveClaimAccount(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    buffer++; // opType byte
-
-    parseStringField(buffer, bufferLength, "Creator", arg, &read, &written);
-    if (argNum == 1) return;
-
-    buffer += read; bufferLength -= read;
-    parseAssetField(buffer, sizeof(asset_t), "Fee", arg, &read, &written);
+    endOperation(&cursor, false);
 }
+#endif
 
-void parseHiveCreateClaimedAccount(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    buffer++; // opType byte
+#ifdef HAVE_HIVE_OP_CLAIM_ACCOUNT
+void parseHiveClaimAccount(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    parseStringField(buffer, bufferLength, "Creator", arg, &read, &written);
-    buffer += read; bufferLength -= read;
+    parseStringField(&cursor, "Creator", arg);
     if (argNum == 0) return;
 
-    parseStringField(buffer, bufferLength, "New Account Name", arg, &read, &written);
-    buffer += read; bufferLength -= read;
-    if (argNum == 1) return;
-
-    char tmp[128];
-
-    parseUint32Field(buffer, bufferLength, "Owner Auth", arg, &read, &written);
-    buffer += read; bufferLength -= read;
-
-    snprintf(tmp, sizeof(tmp), "Weight: %s - ", arg->data);
-    os_memset(arg->data, 0, sizeof(arg->data));
-
-    uint8_t numOwnerAccountAuths = 0;
-    os_memmove(&numOwnerAccountAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numOwnerAccountAuths; ++i) {
-        parseStringField(buffer, bufferLength, "Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "A%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    uint8_t numOwnerKeyAuths = 0;
-    os_memmove(&numOwnerKeyAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numOwnerKeyAuths; ++i) {
-        parsePublicKeyField(buffer, bufferLength, "Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "K%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    if( argNum == 2) { // owner auth
-        os_memset(arg->data, 0, sizeof(arg->data));
-        os_memmove(arg->data, tmp, sizeof(tmp));
-        return;
-    }
-
-    os_memset(tmp, 0, sizeof(tmp));
-
-    parseUint32Field(buffer, bufferLength, "Active Auth", arg, &read, &written);
-    buffer += read; bufferLength -= read;
+    parseAssetField(&cursor, "Fee", arg);
 
-    snprintf(tmp, sizeof(tmp), "Weight: %s - ", arg->data);
-    os_memset(arg->data, 0, sizeof(arg->data));
-
-    uint8_t numActiveAccountAuths = 0;
-    os_memmove(&numActiveAccountAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numActiveAccountAuths; ++i) {
-        parseStringField(buffer, bufferLength, "Active Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "K%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "Active Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    uint8_t numActiveKeyAuths = 0;
-    os_memmove(&numActiveKeyAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numActiveKeyAuths; ++i) {
-        parsePublicKeyField(buffer, bufferLength, "Active Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "K%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "Active Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    if( argNum == 3) { // active auth
-        os_memset(arg->data, 0, sizeof(arg->data));
-        os_memmove(arg->data, tmp, sizeof(tmp));
-        return;
-    }
-
-    os_memset(tmp, 0, sizeof(tmp));
-    os_memset(arg->data, 0, sizeof(arg->data));
-
-    parseUint32Field(buffer, bufferLength, "Posting Auth", arg, &read, &written);
-    buffer += read; bufferLength -= read;
-
-    snprintf(tmp, sizeof(tmp), "Weight: %s - ", arg->data);
-    os_memset(arg->data, 0, sizeof(arg->data));
-
-    uint8_t numPostingAccountAuths = 0;
-    os_memmove(&numPostingAccountAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numPostingAccountAuths; ++i) {
-        parseStringField(buffer, bufferLength, "Posting Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "A%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "Posting Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    uint8_t numPostingKeyAuths = 0;
-    os_memmove(&numPostingKeyAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numPostingKeyAuths; ++i) {
-        parsePublicKeyField(buffer, bufferLength, "Posting Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "K%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "Posting Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    if( argNum == 4) { // posting auth
-        os_memset(arg->data, 0, sizeof(arg->data));
-        os_memmove(arg->data, tmp, sizeof(tmp));
-        return;
-    }
-
-    os_memset(arg->data, 0, sizeof(arg->data));
-
-    parsePublicKeyField(buffer, bufferLength, "Memo Key", arg, &read, &written);
-    buffer += read; bufferLength -= read;
-
-    if( argNum == 5) return;
-
-    os_memset(arg->data, 0, sizeof(arg->data));
-
-    parseStringField(buffer, bufferLength, "JSON Metadata", arg, &read, &written);
+    endOperation(&cursor, true);
 }
+#endif
 
-void parseHiveRequestAccountRecovery(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    buffer++; // opType byte
+#ifdef HAVE_HIVE_OP_CREATE_CLAIMED_ACCOUNT
+uint8_t parseHiveCreateClaimedAccount(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
+    cursor_t cursor;
+    uint8_t page = 2;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    parseStringField(buffer, bufferLength, "Recovery Account", arg, &read, &written);
-    buffer += read; bufferLength -= read;
+    parseStringField(&cursor, "Creator", arg);
+    if (argNum == 0) return 0;
 
-    if (argNum == 0) return;
+    parseStringField(&cursor, "New Account Name", arg);
+    if (argNum == 1) return 0;
 
-    parseStringField(buffer, bufferLength, "Account To Recover", arg, &read, &written);
-    buffer += read; bufferLength -= read;
+    if (parseAuthorityPages(&cursor, "Owner Auth", &page, argNum, arg)) return 0;
+    if (parseAuthorityPages(&cursor, "Active Auth", &page, argNum, arg)) return 0;
+    if (parseAuthorityPages(&cursor, "Posting Auth", &page, argNum, arg)) return 0;
 
-    if (argNum == 1) return;
+    if (parseMemoKeyPage(&cursor, &page, argNum, arg)) return 0;
 
-    char tmp[128];
+    parseStringField(&cursor, "JSON Metadata", arg);
+    if (argNum == page++) return 0;
 
-    parseUint32Field(buffer, bufferLength, "New Owner Auth", arg, &read, &written);
-    buffer += read; bufferLength -= read;
-
-    snprintf(tmp, sizeof(tmp), "Weight: %s - ", arg->data);
-    os_memset(arg->data, 0, sizeof(arg->data));
-
-    uint8_t numOwnerAccountAuths = 0;
-    os_memmove(&numOwnerAccountAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numOwnerAccountAuths; ++i) {
-        parseStringField(buffer, bufferLength, "New Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "A%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "New Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    uint8_t numOwnerKeyAuths = 0;
-    os_memmove(&numOwnerKeyAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numOwnerKeyAuths; ++i) {
-        parsePublicKeyField(buffer, bufferLength, "New Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "K%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "New Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    os_memset(arg->data, 0, sizeof(arg->data));
-    os_memmove(arg->data, tmp, sizeof(tmp));
-    return;
+    endOperation(&cursor, true);
+    return page;
 }
+#endif
 
-void parseHiveRecoverAccount(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
+#ifdef HAVE_HIVE_OP_REQUEST_ACCOUNT_RECOVERY
+uint8_t parseHiveRequestAccountRecovery(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
+    cursor_t cursor;
+    uint8_t page = 2;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    buffer++; // opType byte
+    parseStringField(&cursor, "Recovery Account", arg);
+    if (argNum == 0) return 0;
 
-    parseStringField(buffer, bufferLength, "Account To Recover", arg, &read, &written);
-    buffer += read; bufferLength -= read;
+    parseStringField(&cursor, "Account To Recover", arg);
+    if (argNum == 1) return 0;
 
-    if (argNum == 0) return;
+    if (parseAuthorityPages(&cursor, "New Owner Auth", &page, argNum, arg)) return 0;
 
-    char tmp[128];
-
-    parseUint32Field(buffer, bufferLength, "New Owner Auth", arg, &read, &written);
-    buffer += read; bufferLength -= read;
-
-    snprintf(tmp, sizeof(tmp), "Weight: %s - ", arg->data);
-    os_memset(arg->data, 0, sizeof(arg->data));
-
-    uint8_t numNewOwnerAccountAuths = 0;
-    os_memmove(&numNewOwnerAccountAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numNewOwnerAccountAuths; ++i) {
-        parseStringField(buffer, bufferLength, "New Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "A%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "New Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    uint8_t numNewOwnerKeyAuths = 0;
-    os_memmove(&numNewOwnerKeyAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numNewOwnerKeyAuths; ++i) {
-        parsePublicKeyField(buffer, bufferLength, "New Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "K%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "New Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    if (argNum == 1) {
-        os_memset(arg->data, 0, sizeof(arg->data));
-        os_memmove(arg->data, tmp, sizeof(tmp));
-        return;
-    };
-
-    parseUint32Field(buffer, bufferLength, "Recent Owner Auth", arg, &read, &written);
-    buffer += read; bufferLength -= read;
+    endOperation(&cursor, true);
+    return page;
+}
+#endif
 
-    snprintf(tmp, sizeof(tmp), "Weight: %s - ", arg->data);
-    os_memset(arg->data, 0, sizeof(arg->data));
+#ifdef HAVE_HIVE_OP_RECOVER_ACCOUNT
+uint8_t parseHiveRecoverAccount(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
+    cursor_t cursor;
+    uint8_t page = 1;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    uint8_t numRecentOwnerAccountAuths = 0;
-    os_memmove(&numRecentOwnerAccountAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
+    parseStringField(&cursor, "Account To Recover", arg);
+    if (argNum == 0) return 0;
 
-    for (uint8_t i = 0; i < numRecentOwnerAccountAuths; ++i) {
-        parseStringField(buffer, bufferLength, "Recent Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "A%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "Recent Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    uint8_t numRecentOwnerKeyAuths = 0;
-    os_memmove(&numRecentOwnerKeyAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numRecentOwnerKeyAuths; ++i) {
-        parsePublicKeyField(buffer, bufferLength, "Recent Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "K%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "Recent Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
+    if (parseAuthorityPages(&cursor, "New Owner Auth", &page, argNum, arg)) return 0;
+    if (parseAuthorityPages(&cursor, "Recent Owner Auth", &page, argNum, arg)) return 0;
 
-    os_memset(arg->data, 0, sizeof(arg->data));
-    os_memmove(arg->data, tmp, sizeof(tmp));
+    endOperation(&cursor, true);
+    return page;
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_CHANGE_RECOVERY_ACCOUNT
 void parseHiveChangeRecoveryAccount(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    buffer++; // opType byte
-
-    parseStringField(buffer, bufferLength, "Account To Recover", arg, &read, &written);
+    parseStringField(&cursor, "Account To Recover", arg);
     if (argNum == 0) return;
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "New Recovery Account", arg, &read, &written);
+
+    parseStringField(&cursor, "New Recovery Account", arg);
+
+    endOperation(&cursor, true);
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_TRANSFER_TO_SAVINGS
 void parseHiveTransferToSavings(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    buffer++; // opType byte
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    parseStringField(buffer, bufferLength, "From", arg, &read, &written);
+    parseStringField(&cursor, "From", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "To", arg, &read, &written);
+    parseRecipientField(&cursor, "To", arg);
     if (argNum == 1) return;
 
-    buffer += read; bufferLength -= read;
-    parseAssetField(buffer, bufferLength, "Amount", arg, &read, &written);
+    parseAssetField(&cursor, "Amount", arg);
     if (argNum == 2) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "Memo", arg, &read, &written);
+    parseStringField(&cursor, "Memo", arg);
+
+    endOperation(&cursor, false);
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_TRANSFER_FROM_SAVINGS
 void parseHiveTransferFromSavings(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    buffer++; // opType byte
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    parseStringField(buffer, bufferLength, "From", arg, &read, &written);
+    parseStringField(&cursor, "From", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseUint32Field(buffer, bufferLength, "Request ID", arg, &read, &written);
+    parseUint32Field(&cursor, "Request ID", arg);
     if (argNum == 1) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "To", arg, &read, &written);
+    parseRecipientField(&cursor, "To", arg);
     if (argNum == 2) return;
 
-    buffer += read; bufferLength -= read;
-    parseAssetField(buffer, bufferLength, "Amount", arg, &read, &written);
+    parseAssetField(&cursor, "Amount", arg);
     if (argNum == 3) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "Memo", arg, &read, &written);
+    parseStringField(&cursor, "Memo", arg);
+
+    endOperation(&cursor, false);
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_CANCEL_TRANSFER_FROM_SAVINGS
 void parseHiveCancelTransferFromSavings(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    buffer++; // opType byte
-
-    parseStringField(buffer, bufferLength, "From", arg, &read, &written);
+    parseStringField(&cursor, "From", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseUint32Field(buffer, bufferLength, "Request ID", arg, &read, &written);
-}
+    parseUint32Field(&cursor, "Request ID", arg);
 
-void parseHiveDeclineVotingRights(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    buffer++; // opType byte
-
-    parseStringField(buffer, bufferLength, "Account", arg, &read, &written);
-    if (argNum == 0) return;
-
-    buffer += read; bufferLength -= read;
-    printString(buffer[0] == 0x01 ? "true" : "false", "Decline", arg);
+    endOperation(&cursor, false);
 }
+#endif
 
-void parseHiveResetAccount(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    buffer++; // opType byte
+#ifdef HAVE_HIVE_OP_DECLINE_VOTING_RIGHTS
+void parseHiveDeclineVotingRights(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    parseStringField(buffer, bufferLength, "Reset Account", arg, &read, &written);
+    parseStringField(&cursor, "Account", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "Account To Reset", arg, &read, &written);
-    if (argNum == 1) return;
-
-    buffer += read; bufferLength -= read;
+    parseBoolField(&cursor, "Decline", arg);
 
-    char tmp[128];
+    endOperation(&cursor, false);
+}
+#endif
 
-    parseUint32Field(buffer, bufferLength, "New Owner Auth", arg, &read, &written);
-    buffer += read; bufferLength -= read;
+#ifdef HAVE_HIVE_OP_RESET_ACCOUNT
+uint8_t parseHiveResetAccount(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
+    cursor_t cursor;
+    uint8_t page = 2;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    snprintf(tmp, sizeof(tmp), "Weight: %s - ", arg->data);
-    os_memset(arg->data, 0, sizeof(arg->data));
+    parseStringField(&cursor, "Reset Account", arg);
+    if (argNum == 0) return 0;
 
-    uint8_t numNewOwnerAccountAuths = 0;
-    os_memmove(&numNewOwnerAccountAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
+    parseStringField(&cursor, "Account To Reset", arg);
+    if (argNum == 1) return 0;
 
-    for (uint8_t i = 0; i < numNewOwnerAccountAuths; ++i) {
-        parseStringField(buffer, bufferLength, "New Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "A%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "New Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
+    if (parseAuthorityPages(&cursor, "New Owner Auth", &page, argNum, arg)) return 0;
 
-    uint8_t numNewOwnerKeyAuths = 0;
-    os_memmove(&numNewOwnerKeyAuths, buffer, sizeof(uint8_t));
-    buffer += sizeof(uint8_t); bufferLength -= sizeof(uint8_t);
-
-    for (uint8_t i = 0; i < numNewOwnerKeyAuths; ++i) {
-        parsePublicKeyField(buffer, bufferLength, "New Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "K%d - %s:", i+1, arg->data);
-        parseUint16Field(buffer, bufferLength, "New Owner Auth", arg, &read, &written);
-        buffer += read; bufferLength -= read;
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), "%s || ", arg->data);
-    }
-
-    os_memset(arg->data, 0, sizeof(arg->data));
-    os_memmove(arg->data, tmp, sizeof(tmp));
+    endOperation(&cursor, false);
+    return page;
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_SET_RESET_ACCOUNT
 void parseHiveSetResetAccount(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
-
-    buffer++; // opType byte
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    parseStringField(buffer, bufferLength, "Account", arg, &read, &written);
+    parseStringField(&cursor, "Account", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "Cur Reset Account", arg, &read, &written);
+    parseStringField(&cursor, "Cur Reset Account", arg);
     if (argNum == 1) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "New Reset Account", arg, &read, &written);
+    parseStringField(&cursor, "New Reset Account", arg);
+
+    endOperation(&cursor, false);
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_CLAIM_REWARD_BALANCE
 void parseHiveClaimRewardBalance(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    buffer++; // opType byte
-
-    parseStringField(buffer, bufferLength, "Account", arg, &read, &written);
+    parseStringField(&cursor, "Account", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseAssetField(buffer, bufferLength, "Reward Hive", arg, &read, &written);
+    parseAssetField(&cursor, "Reward Hive", arg);
     if (argNum == 1) return;
 
-    buffer += read; bufferLength -= read;
-    parseAssetField(buffer, bufferLength, "Reward HBD", arg, &read, &written);
+    parseAssetField(&cursor, "Reward HBD", arg);
     if (argNum == 2) return;
 
-    buffer += read; bufferLength -= read;
-    parseAssetField(buffer, bufferLength, "Reward VESTS", arg, &read, &written);
+    parseAssetField(&cursor, "Reward VESTS", arg);
+
+    endOperation(&cursor, false);
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_DELEGATE_VESTING_SHARES
 void parseHiveDelegateVestingShares(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    buffer++; // opType byte
-
-    parseStringField(buffer, bufferLength, "Delegator", arg, &read, &written);
+    parseStringField(&cursor, "Delegator", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "Delegatee", arg, &read, &written);
+    parseStringField(&cursor, "Delegatee", arg);
     if (argNum == 1) return;
 
-    buffer += read; bufferLength -= read;
-    parseAssetField(buffer, bufferLength, "Vesting Shares", arg, &read, &written);
+    parseAssetField(&cursor, "Vesting Shares", arg);
+
+    endOperation(&cursor, false);
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_CREATE_PROPOSAL
 void parseHiveCreateProposal(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    buffer++; // opType byte
-
-    parseStringField(buffer, bufferLength, "Creator", arg, &read, &written);
+    parseStringField(&cursor, "Creator", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "Receiver", arg, &read, &written);
+    parseStringField(&cursor, "Receiver", arg);
     if (argNum == 1) return;
 
-    buffer += read; bufferLength -= read;
-    parseUint32Field(buffer, bufferLength, "Start Date", arg, &read, &written);
+    parseUint32Field(&cursor, "Start Date", arg);
     if (argNum == 2) return;
 
-    buffer += read; bufferLength -= read;
-    parseUint32Field(buffer, bufferLength, "End Date", arg, &read, &written);
+    parseUint32Field(&cursor, "End Date", arg);
     if (argNum == 3) return;
 
-    buffer += read; bufferLength -= read;
-    parseAssetField(buffer, bufferLength, "Daily Pay", arg, &read, &written);
+    parseAssetField(&cursor, "Daily Pay", arg);
     if (argNum == 4) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "Subject", arg, &read, &written);
+    parseStringField(&cursor, "Subject", arg);
     if (argNum == 5) return;
 
-    buffer += read; bufferLength -= read;
-    parseStringField(buffer, bufferLength, "Permlink", arg, &read, &written);
+    parseStringField(&cursor, "Permlink", arg);
+
+    endOperation(&cursor, true);
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_UPDATE_PROPOSAL_VOTES
 void parseHiveUpdateProposalVotes(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    uint32_t numProposals = 0;
-
-    buffer++; // opType byte
-
-    parseStringField(buffer, bufferLength, "Voter", arg, &read, &written);
+    parseStringField(&cursor, "Voter", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-
-    char tmp[128];
-
-    read = unpack_variant32(buffer, sizeof(uint32_t), &numProposals);
-    buffer += read; bufferLength -= read;
-
-    snprintf(tmp, sizeof(tmp), "[ ");
-
-    for(uint32_t i = 0; i < numProposals; ++i) {
-        parseInt64Field(buffer, bufferLength, "Proposal IDs", arg, &read, &written);
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), i == numProposals-1 ? "%s" : "%s, ", arg->data);
-        buffer += read; bufferLength -= read;
-    }
-
-    snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), " ]");
+    parseProposalIdsField(&cursor, "Proposal IDs", arg);
+    if (argNum == 1) return;
 
-    if (argNum == 1) {
-        os_memset(arg->data, 0, sizeof(arg->data));
-        os_memmove(arg->data, tmp, sizeof(tmp));
-        return;
-    }
+    parseBoolField(&cursor, "Approve", arg);
 
-    printString(buffer[0] == 0x01 ? "true" : "false", "Approve", arg);
+    endOperation(&cursor, true);
 }
+#endif
 
+#ifdef HAVE_HIVE_OP_REMOVE_PROPOSAL
 void parseHiveRemoveProposal(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg) {
-    uint32_t read = 0;
-    uint32_t written = 0;
+    cursor_t cursor;
+    initOperationCursor(&cursor, buffer, bufferLength);
 
-    uint32_t numProposals = 0;
-
-    buffer++; // opType byte
-
-    parseStringField(buffer, bufferLength, "Proposal Owner", arg, &read, &written);
+    parseStringField(&cursor, "Proposal Owner", arg);
     if (argNum == 0) return;
 
-    buffer += read; bufferLength -= read;
-
-    char tmp[128];
-
-    read = unpack_variant32(buffer, sizeof(uint32_t), &numProposals);
-    buffer += read; bufferLength -= read;
-
-    snprintf(tmp, sizeof(tmp), "[ ");
-
-    for(uint32_t i = 0; i < numProposals; ++i) {
-        parseInt64Field(buffer, bufferLength, "Proposal IDs", arg, &read, &written);
-        snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), i == numProposals-1 ? "%s" : "%s, ", arg->data);
-        buffer += read; bufferLength -= read;
+    parseProposalIdsField(&cursor, "Proposal IDs", arg);
+
+    endOperation(&cursor, true);
+}
+#endif
+
+#ifdef HAVE_HIVE_TRANSFER_FAST_PATH
+#define OP_TRANSFER 2
+#define OP_TRANSFER_TO_SAVINGS 32
+
+static const char *const transferLabels[TRANSFER_FIELDS] = {"From", "To", "Amount", "Memo"};
+
+bool isHiveTransfer(uint8_t opType) {
+#ifdef HAVE_HIVE_OP_TRANSFER
+    if (opType == OP_TRANSFER) {
+        return true;
+    }
+#endif
+#ifdef HAVE_HIVE_OP_TRANSFER_TO_SAVINGS
+    if (opType == OP_TRANSFER_TO_SAVINGS) {
+        return true;
+    }
+#endif
+    return false;
+}
+
+/**
+ * Walk the fields once. Returns false when they do not fit the data,
+ * the operation is then printed by its regular decoder, which reports
+ * the error on the page.
+*/
+bool indexHiveTransfer(uint8_t *buffer, uint32_t bufferLength, transferFields_t *fields) {
+    cursor_t cursor;
+    asset_t amount;
+    bool indexed = true;
+
+    BEGIN_TRY {
+        TRY {
+            initOperationCursor(&cursor, buffer, bufferLength);
+            for (uint8_t i = 0; i < TRANSFER_FIELDS; ++i) {
+                fields->offset[i] = cursor.ptr - buffer;
+                if (i == 2) {
+                    cursor_read_asset(&cursor, &amount);
+                } else {
+                    cursor_skip(&cursor, cursor_read_varint(&cursor));
+                }
+            }
+        }
+        CATCH_OTHER(e) {
+            indexed = false;
+        }
+        FINALLY {
+        }
+    }
+    END_TRY;
+    return indexed;
+}
+
+void printHiveTransferField(uint8_t *buffer, uint32_t bufferLength, transferFields_t *fields,
+                            uint8_t argNum, actionArgument_t *arg) {
+    cursor_t cursor;
+
+    if (argNum >= TRANSFER_FIELDS) {
+        THROW(EXCEPTION);
+    }
+    cursor_init(&cursor, buffer + fields->offset[argNum], bufferLength - fields->offset[argNum]);
+    if (argNum == 2) {
+        parseAssetField(&cursor, (const char *)PIC(transferLabels[argNum]), arg);
+    } else if (argNum == 1) {
+        parseRecipientField(&cursor, (const char *)PIC(transferLabels[argNum]), arg);
+    } else {
+        parseStringField(&cursor, (const char *)PIC(transferLabels[argNum]), arg);
     }
-
-    snprintf(tmp + strlen(tmp), sizeof(tmp) - strlen(tmp), " ]");
-
-    os_memset(arg->data, 0, sizeof(arg->data));
-    os_memmove(arg->data, tmp, sizeof(tmp));
 }
+#endif
@@ -20,6 +20,56 @@
 
 #include "hive_parse.h"
 
+/**
+ * Every operation is compiled in unless the Makefile selects a subset
+ * with HIVE_OPS, the other operations are then reviewed as arbitrary
+ * data when the user allows it.
+*/
+#ifndef HIVE_OPS_SUBSET
+#define HAVE_HIVE_OP_VOTE
+#define HAVE_HIVE_OP_COMMENT
+#define HAVE_HIVE_OP_TRANSFER
+#define HAVE_HIVE_OP_TRANSFER_TO_VESTING
+#define HAVE_HIVE_OP_WITHDRAW_VESTING
+#define HAVE_HIVE_OP_LIMIT_ORDER_CREATE
+#define HAVE_HIVE_OP_LIMIT_ORDER_CANCEL
+#define HAVE_HIVE_OP_FEED_PUBLISH
+#define HAVE_HIVE_OP_CONVERT
+#define HAVE_HIVE_OP_ACCOUNT_CREATE
+#define HAVE_HIVE_OP_ACCOUNT_UPDATE
+#define HAVE_HIVE_OP_WITNESS_UPDATE
+#define HAVE_HIVE_OP_ACCOUNT_WITNESS_VOTE
+#define HAVE_HIVE_OP_ACCOUNT_WITNESS_PROXY
+#define HAVE_HIVE_OP_DELETE_COMMENT
+#define HAVE_HIVE_OP_CUSTOM_JSON
+#define HAVE_HIVE_OP_COMMENT_OPTIONS
+#define HAVE_HIVE_OP_SET_WITHDRAW_VESTING_ROUTE
+#define HAVE_HIVE_OP_CLAIM_ACCOUNT
+#define HAVE_HIVE_OP_CREATE_CLAIMED_ACCOUNT
+#define HAVE_HIVE_OP_REQUEST_ACCOUNT_RECOVERY
+#define HAVE_HIVE_OP_RECOVER_ACCOUNT
+#define HAVE_HIVE_OP_CHANGE_RECOVERY_ACCOUNT
+#define HAVE_HIVE_OP_TRANSFER_TO_SAVINGS
+#define HAVE_HIVE_OP_TRANSFER_FROM_SAVINGS
+#define HAVE_HIVE_OP_CANCEL_TRANSFER_FROM_SAVINGS
+#define HAVE_HIVE_OP_DECLINE_VOTING_RIGHTS
+#define HAVE_HIVE_OP_RESET_ACCOUNT
+#define HAVE_HIVE_OP_SET_RESET_ACCOUNT
+#define HAVE_HIVE_OP_CLAIM_REWARD_BALANCE
+#define HAVE_HIVE_OP_DELEGATE_VESTING_SHARES
+#define HAVE_HIVE_OP_CREATE_PROPOSAL
+#define HAVE_HIVE_OP_UPDATE_PROPOSAL_VOTES
+#define HAVE_HIVE_OP_REMOVE_PROPOSAL
+#endif
+
+/**
+ * Decoders print page argNum of an operation. Operations holding
+ * authorities have a variable number of pages: their decoder returns 0
+ * once the page is printed, or the page count when argNum is past the
+ * last page, e.g. ARGUMENT_COUNT_QUERY.
+ * Past the last page decoders also check that the operation ends there,
+ * so ARGUMENT_VALIDATE walks the whole operation.
+*/
 void parseHiveVote(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 void parseHiveComment(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 void parseHiveTransfer(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
@@ -29,25 +79,25 @@ void parseHiveLimitOrderCreate(uint8_t *buffer, uint32_t bufferLength, uint8_t a
 void parseHiveLimitOrderCancel(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 void parseHiveFeedPublish(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 void parseHiveConvert(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
-void parseHiveAccountCreate(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
-void parseHiveAccountUpdate(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
+uint8_t parseHiveAccountCreate(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
+uint8_t parseHiveAccountUpdate(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 void parseHiveWitnessUpdate(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 void parseHiveAccountWitnessVote(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 void parseHiveAccountWitnessProxy(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 void parseHiveDeleteComment(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
-void parseHiveCustomJson(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
+uint8_t parseHiveCustomJson(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 void parseHiveCommentOptions(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 void parseHiveSetWithdrawVestingRoute(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 void parseHiveClaimAccount(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
-void parseHiveCreateClaimedAccount(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
-void parseHiveRequestAccountRecovery(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
-void parseHiveRecoverAccount(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
+uint8_t parseHiveCreateClaimedAccount(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
+uint8_t parseHiveRequestAccountRecovery(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
+uint8_t parseHiveRecoverAccount(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 void parseHiveChangeRecoveryAccount(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 void parseHiveTransferToSavings(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 void parseHiveTransferFromSavings(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 void parseHiveCancelTransferFromSavings(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 void parseHiveDeclineVotingRights(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
-void parseHiveResetAccount(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
+uint8_t parseHiveResetAccount(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 void parseHiveSetResetAccount(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 void parseHiveClaimRewardBalance(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 void parseHiveDelegateVestingShares(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
@@ -55,4 +105,24 @@ void parseHiveCreateProposal(uint8_t *buffer, uint32_t bufferLength, uint8_t arg
 void parseHiveUpdateProposalVotes(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 void parseHiveRemoveProposal(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 
+#if defined(HAVE_HIVE_OP_TRANSFER) || defined(HAVE_HIVE_OP_TRANSFER_TO_SAVINGS)
+#define HAVE_HIVE_TRANSFER_FAST_PATH
+#endif
+
+#define TRANSFER_FIELDS 4
+
+/**
+ * Field offsets of a transfer or transfer_to_savings operation (from,
+ * to, amount, memo), found once when it is staged so that each page is
+ * printed straight from its field.
+*/
+typedef struct transferFields_t {
+    uint16_t offset[TRANSFER_FIELDS];
+} transferFields_t;
+
+bool isHiveTransfer(uint8_t opType);
+bool indexHiveTransfer(uint8_t *buffer, uint32_t bufferLength, transferFields_t *fields);
+void printHiveTransferField(uint8_t *buffer, uint32_t bufferLength, transferFields_t *fields,
+                            uint8_t argNum, actionArgument_t *arg);
+
 #endif
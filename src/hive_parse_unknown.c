@@ -17,6 +17,7 @@
 
 #include "hive_parse_unknown.h"
 #include "os.h"
+#include "cx.h"
 #include "hive_utils.h"
 #include <string.h>
 
@@ -26,8 +27,13 @@ void parseUnknownAction(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum,
     } else if (argNum == 1) {
         printString("Verify checksum", "WARNING", arg);
     } else if (argNum == 2) {
+        // the operation data is up to 512 bytes, show its digest
+        cx_sha256_t sha256;
+        uint8_t hash[32];
         char checksum[65] = { 0 };
-        array_hexstr(checksum, buffer, bufferLength);
+        cx_sha256_init(&sha256);
+        cx_hash(&sha256.header, CX_LAST, buffer, bufferLength, hash, sizeof(hash));
+        array_hexstr(checksum, hash, sizeof(hash));
         printString(checksum, "Checksum", arg);
     }
 }
@@ -0,0 +1,286 @@
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "os.h"
+#include "hive_review.h"
+#include <string.h>
+
+typedef struct reviewDefault_t {
+    uint8_t opType;
+    const char *label;
+    const char *value;
+} reviewDefault_t;
+
+/**
+ * Values that the protocol applies when a field is left unset. Only these
+ * are hidden, an empty field may carry a meaning of its own.
+ * A NULL value stands for any zero amount.
+*/
+static const reviewDefault_t reviewDefaults[] = {
+    {2, "Memo", ""},
+    {19, "Max Payout", "1000000.000 HBD"},
+    {19, "Percent HBD", "10000"},
+    {19, "Allow Votes", "true"},
+    {19, "Allow Curation Rewards", "true"},
+    {19, "Beneficiaries", "[]"},
+    {32, "Memo", ""},
+    {33, "Memo", ""},
+    {39, "Reward Hive", NULL},
+    {39, "Reward HBD", NULL},
+    {39, "Reward VESTS", NULL},
+};
+
+void initReviewCache(reviewCache_t *cache) {
+    os_memset(cache->argNum, REVIEW_PAGE_EMPTY, sizeof(cache->argNum));
+    cache->pageCount = 0;
+    cache->opIndex = 0;
+    cache->current = 0;
+    cache->active = false;
+    cache->currentPending = false;
+}
+
+/**
+ * Pages belong to a single operation. Drop them once the reviewed
+ * operation has been accepted.
+*/
+static void syncReviewCache(reviewCache_t *cache, txProcessingContext_t *context) {
+    uint32_t opIndex = reviewedOperation(context)->opIndex;
+
+    if (cache->opIndex != opIndex) {
+        os_memset(cache->argNum, REVIEW_PAGE_EMPTY, sizeof(cache->argNum));
+        cache->opIndex = opIndex;
+    }
+}
+
+static bool isZeroAmount(const char *data) {
+    for (; *data != '\0' && *data != ' '; ++data) {
+        if (*data != '0' && *data != '.') {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool isDefaultArgument(uint8_t opType, actionArgument_t *arg) {
+    for (uint8_t i = 0; i < sizeof(reviewDefaults) / sizeof(reviewDefaults[0]); ++i) {
+        const reviewDefault_t *entry = &reviewDefaults[i];
+        const char *value = (const char *)PIC(entry->value);
+
+        if (entry->opType != opType || strcmp(arg->label, (const char *)PIC(entry->label)) != 0) {
+            continue;
+        }
+        return value == NULL ? isZeroAmount(arg->data) : strcmp(arg->data, value) == 0;
+    }
+    return false;
+}
+
+/**
+ * Decode an argument without reporting errors, returns false when it
+ * could not be decoded.
+*/
+static bool tryPrintArgument(uint8_t argNum, txProcessingContext_t *context, actionArgument_t *arg) {
+    bool decoded = true;
+
+    BEGIN_TRY {
+        TRY {
+            printArgumentTo(argNum, context, arg);
+        }
+        CATCH_OTHER(e) {
+            decoded = false;
+        }
+        FINALLY {
+        }
+    }
+    END_TRY;
+    return decoded;
+}
+
+static bool canSharePage(actionArgument_t *first, actionArgument_t *second) {
+    return strlen(first->data) <= REVIEW_SHORT_FIELD &&
+           strlen(second->data) <= REVIEW_SHORT_FIELD &&
+           strlen(first->label) + strlen(second->label) + 3 < sizeof(first->label);
+}
+
+/**
+ * Lay out the pages of the reviewed operation and return their count.
+ * In compact mode every argument is decoded once to find the hidden and
+ * packed ones. An argument that fails to decode keeps its own page, so
+ * the error is reported when that page is displayed.
+*/
+uint8_t mapReviewPages(reviewCache_t *cache, txProcessingContext_t *context, bool compact) {
+    operationSlot_t *operation = reviewedOperation(context);
+    actionArgument_t previous;
+    bool previousShort = false;
+    uint8_t count = 0;
+
+    if (operation->argumentCount > REVIEW_MAP_PAGES) {
+        THROW(EXCEPTION_OVERFLOW);
+    }
+    syncReviewCache(cache, context);
+    os_memset(cache->pageArgs, REVIEW_PAGE_EMPTY, sizeof(cache->pageArgs));
+
+    for (uint8_t argNum = 0; argNum < operation->argumentCount; ++argNum) {
+        actionArgument_t arg;
+        bool decoded;
+
+        if (!compact) {
+            cache->pageArgs[count++][0] = argNum;
+            continue;
+        }
+
+        decoded = tryPrintArgument(argNum, context, &arg);
+
+        if (decoded && isDefaultArgument(operation->opType, &arg)) {
+            continue;
+        }
+        if (REVIEW_PAGE_FIELDS > 1 && decoded && previousShort && canSharePage(&previous, &arg)) {
+            cache->pageArgs[count - 1][REVIEW_PAGE_FIELDS - 1] = argNum;
+            previousShort = false;
+            continue;
+        }
+        cache->pageArgs[count++][0] = argNum;
+        previousShort = decoded;
+        if (decoded) {
+            os_memmove(&previous, &arg, sizeof(actionArgument_t));
+        }
+    }
+
+    // every field is a default one, still show the first
+    if (count == 0 && operation->argumentCount > 0) {
+        cache->pageArgs[count++][0] = 0;
+    }
+
+    cache->pageCount = count;
+    cache->current = 0;
+    return count;
+}
+
+/**
+ * Lay out the pages again as more of the reviewed operation is
+ * received, staying on the current page.
+*/
+uint8_t remapReviewPages(reviewCache_t *cache, txProcessingContext_t *context, bool compact) {
+    uint8_t current = cache->current;
+    uint8_t count = mapReviewPages(cache, context, compact);
+
+    if (count != 0) {
+        cache->current = (current < count ? current : count - 1);
+    }
+    return count;
+}
+
+/**
+ * Return field of page, decoding it only when it has not been prefetched.
+ * A field of an operation still being received may not be there yet, it
+ * is then shown as pending and decoded again on the next display.
+*/
+static actionArgument_t *loadReviewField(reviewCache_t *cache, txProcessingContext_t *context,
+                                         uint8_t page, uint8_t field) {
+    uint8_t slot = (page % REVIEW_CACHE_PAGES) * REVIEW_PAGE_FIELDS + field;
+    uint8_t argNum = cache->pageArgs[page][field];
+    actionArgument_t *arg = &cache->pages[slot];
+
+    if (cache->argNum[slot] != argNum) {
+        cache->argNum[slot] = REVIEW_PAGE_EMPTY;
+        if (!partialOperation(context)) {
+            printArgumentTo(argNum, context, arg);
+        } else if (!tryPrintArgument(argNum, context, arg)) {
+            strcpy(arg->label, "Receiving");
+            strcpy(arg->data, "...");
+            cache->currentPending = true;
+            return arg;
+        }
+        cache->argNum[slot] = argNum;
+    }
+    return arg;
+}
+
+/**
+ * Display page, its fields separated by a slash when it holds several.
+*/
+void showReviewPage(reviewCache_t *cache, txProcessingContext_t *context, uint8_t page) {
+    actionArgument_t *arg = &context->content->arg;
+
+    if (page >= cache->pageCount) {
+        THROW(EXCEPTION_OVERFLOW);
+    }
+    syncReviewCache(cache, context);
+    cache->currentPending = false;
+    os_memmove(arg, loadReviewField(cache, context, page, 0), sizeof(actionArgument_t));
+
+    for (uint8_t field = 1; field < REVIEW_PAGE_FIELDS; ++field) {
+        if (cache->pageArgs[page][field] == REVIEW_PAGE_EMPTY) {
+            break;
+        }
+        actionArgument_t *next = loadReviewField(cache, context, page, field);
+        snprintf(arg->label + strlen(arg->label), sizeof(arg->label) - strlen(arg->label), " / %s", next->label);
+        snprintf(arg->data + strlen(arg->data), sizeof(arg->data) - strlen(arg->data), " / %s", next->data);
+    }
+
+    cache->current = page;
+    cache->active = true;
+}
+
+static bool fillReviewPage(reviewCache_t *cache, txProcessingContext_t *context, uint8_t page) {
+    bool filled = false;
+
+    if (page >= cache->pageCount) {
+        return false;
+    }
+
+    for (uint8_t field = 0; field < REVIEW_PAGE_FIELDS && !filled; ++field) {
+        uint8_t slot = (page % REVIEW_CACHE_PAGES) * REVIEW_PAGE_FIELDS + field;
+        uint8_t argNum = cache->pageArgs[page][field];
+
+        if (argNum == REVIEW_PAGE_EMPTY || cache->argNum[slot] == argNum) {
+            continue;
+        }
+
+        cache->argNum[slot] = REVIEW_PAGE_EMPTY;
+        if (tryPrintArgument(argNum, context, &cache->pages[slot])) {
+            cache->argNum[slot] = argNum;
+        } else {
+            // stop until the page is displayed and the error is reported there
+            cache->active = false;
+        }
+        filled = true;
+    }
+    return filled;
+}
+
+/**
+ * Format at most one field of the pages around the displayed one,
+ * forward first. Called on idle ticker events, returns true when a
+ * field was decoded.
+*/
+bool prefetchReviewPage(reviewCache_t *cache, txProcessingContext_t *context) {
+    if (!cache->active || (pendingOperations(context) == 0 && !partialOperation(context))) {
+        return false;
+    }
+    // the page map belongs to another operation until it is displayed
+    if (cache->opIndex != reviewedOperation(context)->opIndex) {
+        return false;
+    }
+
+    if (fillReviewPage(cache, context, cache->current + 1)) {
+        return true;
+    }
+    if (cache->active && cache->current > 0) {
+        return fillReviewPage(cache, context, cache->current - 1);
+    }
+    return false;
+}
@@ -0,0 +1,71 @@
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __HIVE_REVIEW_H__
+#define __HIVE_REVIEW_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hive_parse.h"
+#include "hive_stream.h"
+
+// the displayed page and its two neighbours
+#define REVIEW_CACHE_PAGES 3
+
+// short fields share a page on the larger Nano X screen
+#if defined(TARGET_NANOX)
+#define REVIEW_PAGE_FIELDS 2
+#else
+#define REVIEW_PAGE_FIELDS 1
+#endif
+
+#define REVIEW_CACHE_FIELDS (REVIEW_CACHE_PAGES * REVIEW_PAGE_FIELDS)
+
+#define REVIEW_MAP_PAGES MAX_ARGUMENT_COUNT
+
+// longest value that still shares a page with another one
+#define REVIEW_SHORT_FIELD 20
+
+#define REVIEW_PAGE_EMPTY 0xFF
+
+/**
+ * Pre-formatted review pages of the operation being displayed.
+ * The page map lists the arguments shown on each page, in compact mode
+ * arguments left to their protocol default are hidden and short ones
+ * are packed together.
+ * The arguments of a page live in the slots of page % REVIEW_CACHE_PAGES,
+ * so the pages around the current position never evict each other.
+*/
+typedef struct reviewCache_t {
+    actionArgument_t pages[REVIEW_CACHE_FIELDS];
+    uint8_t argNum[REVIEW_CACHE_FIELDS];
+    uint8_t pageArgs[REVIEW_MAP_PAGES][REVIEW_PAGE_FIELDS];
+    uint8_t pageCount;
+    uint32_t opIndex;
+    uint8_t current;
+    bool active;
+    // the current page shows fields not received yet
+    bool currentPending;
+} reviewCache_t;
+
+void initReviewCache(reviewCache_t *cache);
+uint8_t mapReviewPages(reviewCache_t *cache, txProcessingContext_t *context, bool compact);
+uint8_t remapReviewPages(reviewCache_t *cache, txProcessingContext_t *context, bool compact);
+void showReviewPage(reviewCache_t *cache, txProcessingContext_t *context, uint8_t page);
+bool prefetchReviewPage(reviewCache_t *cache, txProcessingContext_t *context);
+
+#endif // __HIVE_REVIEW_H__
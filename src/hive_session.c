@@ -0,0 +1,367 @@
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "hive_session.h"
+#include "hive_sign.h"
+#include "hive_cursor.h"
+#include <string.h>
+
+#define HARDENED 0x80000000
+#define OP_VOTE 0
+#define OP_FEED_PUBLISH 7
+#define OP_CUSTOM_JSON 18
+
+// keeps the cross products of the band check within 62 bits
+#define MAX_FEED_AMOUNT (1LL << 24)
+
+// SLIP-0048 Hive paths are 48'/13'/role'/account'/key'
+static const uint32_t POSTING_ROLE_PREFIX[] = {48 | HARDENED, 13 | HARDENED, 4 | HARDENED};
+static const uint32_t ACTIVE_ROLE_PREFIX[] = {48 | HARDENED, 13 | HARDENED, 1 | HARDENED};
+
+static bool is_posting_operation(uint8_t opType) {
+    return (opType == OP_VOTE || opType == OP_CUSTOM_JSON);
+}
+
+static bool is_valid_account_name(uint8_t *name, uint32_t length) {
+    uint32_t i;
+    if (length < 3 || length > HIVE_ACCOUNT_NAME_LENGTH) {
+        return false;
+    }
+    for (i = 0; i < length; i++) {
+        char c = name[i];
+        if (!((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '.')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void parse_accounts(hiveSession_t *session, cursor_t *cursor, uint8_t maxAccounts) {
+    uint32_t i;
+
+    session->accountCount = cursor_read_u8(cursor);
+    if (session->accountCount == 0 || session->accountCount > maxAccounts) {
+        THROW(0x6a80);
+    }
+    for (i = 0; i < session->accountCount; i++) {
+        uint8_t nameLength = cursor_read_u8(cursor);
+        uint8_t *name = cursor_read_bytes(cursor, nameLength);
+        if (!is_valid_account_name(name, nameLength)) {
+            THROW(0x6a80);
+        }
+        os_memmove(session->accounts[i], name, nameLength);
+        session->accounts[i][nameLength] = '\0';
+    }
+}
+
+/**
+ * Read the session request, all integers are big endian:
+ * [path length][path][signatures u16][minutes u16] followed by
+ * posting: [op count][op types][account count]([name length][name])*
+ * witness: [band bps u16][1]([name length][name]) for the publisher
+ * Returns the number of bytes read.
+*/
+uint32_t hive_session_parse(hiveSession_t *session, hiveSessionKind_e kind, uint8_t *buffer, uint32_t length) {
+    cursor_t cursor;
+    uint8_t *p;
+    uint16_t minutes;
+    uint32_t i;
+
+    hive_session_revoke(session);
+    session->kind = kind;
+    cursor_init(&cursor, buffer, length);
+
+    session->pathLength = cursor_read_u8(&cursor);
+    if (session->pathLength != 5) {
+        THROW(0x6a80);
+    }
+    for (i = 0; i < session->pathLength; i++) {
+        p = cursor_read_bytes(&cursor, 4);
+        session->path[i] = (p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+    }
+    if (memcmp(session->path, (kind == HIVE_SESSION_POSTING ? POSTING_ROLE_PREFIX : ACTIVE_ROLE_PREFIX),
+               sizeof(POSTING_ROLE_PREFIX)) != 0) {
+        PRINTF("Wrong key role for the session\n");
+        THROW(0x6a80);
+    }
+
+    p = cursor_read_bytes(&cursor, 4);
+    session->signaturesLeft = (p[0] << 8) | p[1];
+    minutes = (p[2] << 8) | p[3];
+    if (session->signaturesLeft == 0 || session->signaturesLeft > HIVE_SESSION_MAX_SIGNATURES ||
+        minutes == 0 || minutes > HIVE_SESSION_MAX_MINUTES) {
+        THROW(0x6a80);
+    }
+    session->ticksLeft = (uint32_t)minutes * HIVE_SESSION_TICKS_PER_MINUTE;
+
+    if (kind == HIVE_SESSION_WITNESS) {
+        p = cursor_read_bytes(&cursor, 2);
+        session->bandBps = (p[0] << 8) | p[1];
+        if (session->bandBps == 0 || session->bandBps > HIVE_SESSION_MAX_BAND_BPS) {
+            THROW(0x6a80);
+        }
+        session->opTypeCount = 1;
+        session->opTypes[0] = OP_FEED_PUBLISH;
+        parse_accounts(session, &cursor, 1);
+    } else {
+        session->opTypeCount = cursor_read_u8(&cursor);
+        if (session->opTypeCount == 0 || session->opTypeCount > HIVE_SESSION_MAX_OP_TYPES) {
+            THROW(0x6a80);
+        }
+        for (i = 0; i < session->opTypeCount; i++) {
+            session->opTypes[i] = cursor_read_u8(&cursor);
+            if (!is_posting_operation(session->opTypes[i])) {
+                THROW(0x6a80);
+            }
+        }
+        parse_accounts(session, &cursor, HIVE_SESSION_MAX_ACCOUNTS);
+    }
+
+    return length - cursor_remaining(&cursor);
+}
+
+/**
+ * Derive the session key once the user approved the session.
+*/
+void hive_session_activate(hiveSession_t *session) {
+    uint8_t privateKeyData[64];
+
+    os_perso_derive_node_bip32(CX_CURVE_256K1, session->path, session->pathLength,
+                               privateKeyData, NULL);
+    cx_ecfp_init_private_key(CX_CURVE_256K1, privateKeyData, 32, &session->privateKey);
+    os_memset(privateKeyData, 0, sizeof(privateKeyData));
+    session->active = true;
+}
+
+void hive_session_revoke(hiveSession_t *session) {
+    os_memset(session, 0, sizeof(hiveSession_t));
+}
+
+bool hive_session_matches_path(hiveSession_t *session, uint8_t pathLength, uint32_t *path) {
+    return session->active && pathLength == session->pathLength &&
+           memcmp(path, session->path, pathLength * sizeof(uint32_t)) == 0;
+}
+
+static bool is_session_account(hiveSession_t *session, cursor_t *cursor) {
+    uint32_t length = cursor_read_varint(cursor);
+    uint8_t *name = cursor_read_bytes(cursor, length);
+    uint8_t i;
+
+    for (i = 0; i < session->accountCount; i++) {
+        if (strlen(session->accounts[i]) == length && memcmp(session->accounts[i], name, length) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Read a feed_publish of the session publisher, returns false for any
+ * other publisher.
+*/
+static bool read_feed(hiveSession_t *session, cursor_t *cursor, asset_t *base, asset_t *quote) {
+    if (!is_session_account(session, cursor)) {
+        return false;
+    }
+    cursor_read_asset(cursor, base);
+    cursor_read_asset(cursor, quote);
+    return true;
+}
+
+static bool is_feed_amount(asset_t *asset) {
+    return asset->amount > 0 && asset->amount < MAX_FEED_AMOUNT;
+}
+
+static bool same_symbol(asset_t *a, asset_t *b) {
+    return a->precision == b->precision && memcmp(a->symbol, b->symbol, sizeof(a->symbol)) == 0;
+}
+
+/**
+ * Whether base / quote is within bandBps of the reference price,
+ * compared by cross multiplication:
+ * |base * refQuote - refBase * quote| * 10000 <= bandBps * refBase * quote
+*/
+static bool is_within_band(hiveSession_t *session, asset_t *base, asset_t *quote) {
+    int64_t deviation;
+
+    if (!session->hasReference ||
+        !same_symbol(base, &session->referenceBase) || !same_symbol(quote, &session->referenceQuote)) {
+        return false;
+    }
+    if (!is_feed_amount(base) || !is_feed_amount(quote) ||
+        !is_feed_amount(&session->referenceBase) || !is_feed_amount(&session->referenceQuote)) {
+        return false;
+    }
+
+    deviation = base->amount * session->referenceQuote.amount -
+                session->referenceBase.amount * quote->amount;
+    if (deviation < 0) {
+        deviation = -deviation;
+    }
+    return deviation * 10000 <= (int64_t)session->bandBps * session->referenceBase.amount * quote->amount;
+}
+
+static bool check_operation(hiveSession_t *session, uint8_t opType, cursor_t *cursor) {
+    uint32_t count;
+    asset_t base;
+    asset_t quote;
+
+    switch (opType) {
+    case OP_VOTE:
+        // voter
+        return is_session_account(session, cursor);
+    case OP_CUSTOM_JSON:
+        // no active authority, and only session accounts as posting authorities
+        if (cursor_read_varint(cursor) != 0) {
+            return false;
+        }
+        count = cursor_read_varint(cursor);
+        if (count == 0) {
+            return false;
+        }
+        while (count-- > 0) {
+            if (!is_session_account(session, cursor)) {
+                return false;
+            }
+        }
+        return true;
+    case OP_FEED_PUBLISH:
+        // signed feeds never move the reference, only approved ones do
+        return read_feed(session, cursor, &base, &quote) && is_within_band(session, &base, &quote);
+    default:
+        return false;
+    }
+}
+
+/**
+ * Whether a staged operation can be signed without review.
+*/
+bool hive_session_allows(hiveSession_t *session, uint8_t opType, uint8_t *data, uint32_t length) {
+    cursor_t cursor;
+    bool allowed = false;
+    uint8_t i;
+
+    if (!session->active) {
+        return false;
+    }
+    for (i = 0; i < session->opTypeCount; i++) {
+        if (session->opTypes[i] == opType) {
+            break;
+        }
+    }
+    if (i == session->opTypeCount) {
+        return false;
+    }
+
+    BEGIN_TRY {
+        TRY {
+            cursor_init(&cursor, data, length);
+            cursor_read_varint(&cursor);
+            allowed = check_operation(session, opType, &cursor);
+        }
+        CATCH_OTHER(e) {
+            allowed = false;
+        }
+        FINALLY {
+        }
+    }
+    END_TRY;
+
+    return allowed;
+}
+
+/**
+ * Prices approved in a transaction only become the reference once it is signed.
+*/
+void hive_session_begin_tx(hiveSession_t *session) {
+    session->hasPending = false;
+}
+
+/**
+ * Remember a feed of the publisher the user approved through review.
+*/
+void hive_session_record(hiveSession_t *session, uint8_t opType, uint8_t *data, uint32_t length) {
+    cursor_t cursor;
+    asset_t base;
+    asset_t quote;
+
+    if (!session->active || session->kind != HIVE_SESSION_WITNESS || opType != OP_FEED_PUBLISH) {
+        return;
+    }
+
+    BEGIN_TRY {
+        TRY {
+            cursor_init(&cursor, data, length);
+            cursor_read_varint(&cursor);
+            if (read_feed(session, &cursor, &base, &quote)) {
+                session->pendingBase = base;
+                session->pendingQuote = quote;
+                session->hasPending = true;
+            }
+        }
+        CATCH_OTHER(e) {
+        }
+        FINALLY {
+        }
+    }
+    END_TRY;
+}
+
+/**
+ * The transaction is signed, its last feed is the new reference price.
+*/
+void hive_session_commit(hiveSession_t *session) {
+    if (session->active && session->hasPending) {
+        session->referenceBase = session->pendingBase;
+        session->referenceQuote = session->pendingQuote;
+        session->hasReference = true;
+        session->hasPending = false;
+    }
+}
+
+/**
+ * Sign with the session key, the session ends with its last signature.
+*/
+uint32_t hive_session_sign(hiveSession_t *session, uint8_t *hash, uint8_t *signature) {
+    if (!session->active) {
+        THROW(0x6985);
+    }
+    hive_sign_digest(&session->privateKey, hash, signature);
+    if (--session->signaturesLeft == 0) {
+        hive_session_revoke(session);
+    }
+    return HIVE_SIGNATURE_LENGTH;
+}
+
+uint16_t hive_session_minutes_left(hiveSession_t *session) {
+    return (session->ticksLeft + HIVE_SESSION_TICKS_PER_MINUTE - 1) / HIVE_SESSION_TICKS_PER_MINUTE;
+}
+
+/**
+ * Count down the session time on each ticker event. Returns true when
+ * the minutes left changed, so the status can be refreshed.
+*/
+bool hive_session_tick(hiveSession_t *session) {
+    if (!session->active) {
+        return false;
+    }
+    if (--session->ticksLeft == 0) {
+        hive_session_revoke(session);
+        return true;
+    }
+    return (session->ticksLeft % HIVE_SESSION_TICKS_PER_MINUTE) == 0;
+}
@@ -0,0 +1,85 @@
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __HIVE_SESSION_H__
+#define __HIVE_SESSION_H__
+
+#include "os.h"
+#include "cx.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include "hive_types.h"
+
+#define HIVE_SESSION_MAX_PATH 10
+#define HIVE_SESSION_MAX_ACCOUNTS 4
+#define HIVE_SESSION_MAX_OP_TYPES 2
+#define HIVE_SESSION_MAX_SIGNATURES 1000
+#define HIVE_SESSION_MAX_MINUTES 1440
+#define HIVE_SESSION_MAX_BAND_BPS 2000
+#define HIVE_ACCOUNT_NAME_LENGTH 16
+
+// the SE sends a ticker event every 100 ms
+#define HIVE_SESSION_TICKS_PER_MINUTE 600
+
+typedef enum hiveSessionKind_e {
+    HIVE_SESSION_POSTING = 0x00,
+    HIVE_SESSION_WITNESS = 0x01
+} hiveSessionKind_e;
+
+/**
+ * A key kept in RAM that signs, without review, transactions made only
+ * of whitelisted operations of whitelisted accounts.
+ * Posting sessions sign votes and custom_json, and end on any other
+ * operation. Witness sessions sign feed_publish of their publisher while
+ * the price stays within a band of the last approved one, anything else
+ * is reviewed. Both end when a limit is reached or the application exits.
+*/
+typedef struct hiveSession_t {
+    bool active;
+    hiveSessionKind_e kind;
+    uint8_t pathLength;
+    uint32_t path[HIVE_SESSION_MAX_PATH];
+    cx_ecfp_private_key_t privateKey;
+    uint8_t opTypeCount;
+    uint8_t opTypes[HIVE_SESSION_MAX_OP_TYPES];
+    uint8_t accountCount;
+    char accounts[HIVE_SESSION_MAX_ACCOUNTS][HIVE_ACCOUNT_NAME_LENGTH + 1];
+    uint16_t signaturesLeft;
+    uint32_t ticksLeft;
+    // witness price band, in basis points of the last approved price
+    uint16_t bandBps;
+    bool hasReference;
+    asset_t referenceBase;
+    asset_t referenceQuote;
+    bool hasPending;
+    asset_t pendingBase;
+    asset_t pendingQuote;
+} hiveSession_t;
+
+uint32_t hive_session_parse(hiveSession_t *session, hiveSessionKind_e kind, uint8_t *buffer, uint32_t length);
+void hive_session_activate(hiveSession_t *session);
+void hive_session_revoke(hiveSession_t *session);
+bool hive_session_matches_path(hiveSession_t *session, uint8_t pathLength, uint32_t *path);
+bool hive_session_allows(hiveSession_t *session, uint8_t opType, uint8_t *data, uint32_t length);
+void hive_session_begin_tx(hiveSession_t *session);
+void hive_session_record(hiveSession_t *session, uint8_t opType, uint8_t *data, uint32_t length);
+void hive_session_commit(hiveSession_t *session);
+uint32_t hive_session_sign(hiveSession_t *session, uint8_t *hash, uint8_t *signature);
+bool hive_session_tick(hiveSession_t *session);
+uint16_t hive_session_minutes_left(hiveSession_t *session);
+
+#endif // __HIVE_SESSION_H__
@@ -0,0 +1,168 @@
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "hive_sign.h"
+#include <stdbool.h>
+
+#define HASH_LENGTH 32
+#define DER_MAX_LENGTH 72
+
+static const uint8_t SECP256K1_N[] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe,
+    0xba, 0xae, 0xdc, 0xe6, 0xaf, 0x48, 0xa0, 0x3b,
+    0xbf, 0xd2, 0x5e, 0x8c, 0xd0, 0x36, 0x41, 0x41};
+
+/**
+ * RFC6979 state kept across canonical retries. hmacK is HMAC keyed
+ * with K, set up once each time K changes and copied for every V update.
+*/
+typedef struct rfc6979Context_t
+{
+    uint8_t V[HASH_LENGTH + 1];
+    uint8_t K[HASH_LENGTH];
+    cx_hmac_sha256_t hmacK;
+} rfc6979Context_t;
+
+static void rfc6979_set_key(rfc6979Context_t *ctx)
+{
+    cx_hmac_sha256_init(&ctx->hmacK, ctx->K, HASH_LENGTH);
+}
+
+// V = HMAC_K(V)
+static void rfc6979_update_v(rfc6979Context_t *ctx)
+{
+    cx_hmac_sha256_t hmac;
+    os_memmove(&hmac, &ctx->hmacK, sizeof(hmac));
+    cx_hmac((cx_hmac_t *)&hmac, CX_LAST, ctx->V, HASH_LENGTH, ctx->V, HASH_LENGTH);
+}
+
+// K = HMAC_K(V || sep || x || h1), x and h1 are skipped when x is NULL
+static void rfc6979_update_k(rfc6979Context_t *ctx, uint8_t sep,
+                             uint8_t *x, uint32_t xLength, uint8_t *h1)
+{
+    cx_hmac_sha256_t hmac;
+    os_memmove(&hmac, &ctx->hmacK, sizeof(hmac));
+    ctx->V[HASH_LENGTH] = sep;
+    if (x)
+    {
+        cx_hmac((cx_hmac_t *)&hmac, 0, ctx->V, HASH_LENGTH + 1, ctx->K, HASH_LENGTH);
+        cx_hmac((cx_hmac_t *)&hmac, 0, x, xLength, ctx->K, HASH_LENGTH);
+        cx_hmac((cx_hmac_t *)&hmac, CX_LAST, h1, HASH_LENGTH, ctx->K, HASH_LENGTH);
+    }
+    else
+    {
+        cx_hmac((cx_hmac_t *)&hmac, CX_LAST, ctx->V, HASH_LENGTH + 1, ctx->K, HASH_LENGTH);
+    }
+    rfc6979_set_key(ctx);
+}
+
+/**
+ * The nonce generated by internal library CX_RND_RFC6979 is not compatible
+ * with Hive. Steps b. to g. of RFC6979, run once per signature.
+*/
+static void rfc6979_init(rfc6979Context_t *ctx, uint8_t *x, uint32_t xLength, uint8_t *h1)
+{
+    os_memset(ctx->V, 0x01, HASH_LENGTH);
+    os_memset(ctx->K, 0x00, HASH_LENGTH);
+    rfc6979_set_key(ctx);
+    rfc6979_update_k(ctx, 0x00, x, xLength, h1);
+    rfc6979_update_v(ctx);
+    rfc6979_update_k(ctx, 0x01, x, xLength, h1);
+    rfc6979_update_v(ctx);
+}
+
+/**
+ * Step h. of RFC6979. As only secp256k1/sha256 is supported T is a single
+ * HMAC output. The range check is the one Hive nodes historically used
+ * and must stay as is for the signatures to remain deterministic.
+*/
+static void rfc6979_next(rfc6979Context_t *ctx, uint8_t *rnd, bool first)
+{
+    uint32_t i;
+    for (;;)
+    {
+        if (!first)
+        {
+            // h.3  K = HMAC_K(V || 0x00), V = HMAC_K(V)
+            rfc6979_update_k(ctx, 0x00, NULL, 0, NULL);
+            rfc6979_update_v(ctx);
+        }
+        first = false;
+        rfc6979_update_v(ctx);
+        for (i = 0; i < HASH_LENGTH; i++)
+        {
+            if (ctx->V[i] < SECP256K1_N[i])
+            {
+                os_memmove(rnd, ctx->V, HASH_LENGTH);
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * A signature is canonical for Hive when both r and s are 32 bytes long
+ * with the high bit cleared, or 31 bytes long with the high bit set. In
+ * DER both cases encode as an integer of exactly 32 bytes, so the check
+ * and the r || s extraction are done on the DER output directly.
+ * DER layout : 30 L 02 Lr r 02 Ls s
+*/
+static bool der_extract_canonical(const uint8_t *der, uint8_t *rs)
+{
+    if ((der[3] != 32) || (der[4 + 32 + 1] != 32))
+    {
+        return false;
+    }
+    os_memmove(rs, der + 4, 32);
+    os_memmove(rs + 32, der + 4 + 32 + 2, 32);
+    return true;
+}
+
+uint32_t hive_sign_digest(cx_ecfp_private_key_t *privateKey,
+                          uint8_t *hash,
+                          uint8_t *signature)
+{
+    rfc6979Context_t rfc6979;
+    uint8_t der[DER_MAX_LENGTH];
+    uint32_t tries = 0;
+    uint32_t infos;
+
+    rfc6979_init(&rfc6979, privateKey->d, privateKey->d_len, hash);
+
+    // Loop until a candidate matching the canonical signature is found
+    for (;;)
+    {
+        // the nonce is provided in the output buffer
+        rfc6979_next(&rfc6979, der, (tries == 0));
+        cx_ecdsa_sign(privateKey, CX_NO_CANONICAL | CX_RND_PROVIDED | CX_LAST, CX_SHA256,
+                      hash, HASH_LENGTH,
+                      der, sizeof(der),
+                      &infos);
+        if (der_extract_canonical(der, signature + 1))
+        {
+            signature[0] = 27 + 4 + (((infos & CX_ECCINFO_PARITY_ODD) != 0) ? 1 : 0);
+            break;
+        }
+        tries++;
+    }
+
+    os_memset(&rfc6979, 0, sizeof(rfc6979));
+    os_memset(der, 0, sizeof(der));
+
+    return tries;
+}
@@ -0,0 +1,35 @@
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __HIVE_SIGN_H__
+#define __HIVE_SIGN_H__
+
+#include "os.h"
+#include "cx.h"
+#include <stdint.h>
+
+#define HIVE_SIGNATURE_LENGTH 65
+
+/**
+ * Sign a 32 bytes digest with a Hive canonical signature, written as
+ * v || r || s to signature. Returns the number of rejected candidates.
+*/
+uint32_t hive_sign_digest(cx_ecfp_private_key_t *privateKey,
+                          uint8_t *hash,
+                          uint8_t *signature);
+
+#endif
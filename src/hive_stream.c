@@ -27,328 +27,329 @@
 
 void initTxContext(txProcessingContext_t *context, 
                    cx_sha256_t *sha256, 
-                   cx_sha256_t *dataSha256, 
                    txProcessingContent_t *processingContent,
-                   uint8_t dataAllowed) {
+                   uint8_t dataAllowed,
+                   bool compressed,
+                   hiveTemplate_t *template) {
     os_memset(context, 0, sizeof(txProcessingContext_t));
     context->sha256 = sha256;
-    context->dataSha256 = dataSha256;
     context->content = processingContent;
     context->state = TLV_CHAIN_ID;
     context->dataAllowed = dataAllowed;
-    cx_sha256_init(context->sha256);
-    cx_sha256_init(context->dataSha256);
-}
-
-uint8_t readTxByte(txProcessingContext_t *context) {
-    uint8_t data;
-    if (context->commandLength < 1) {
-        PRINTF("readTxByte Underflow\n");
-        THROW(EXCEPTION);
+    context->compressed = compressed;
+    if (compressed) {
+        lz_init(&context->lz);
     }
-    data = *context->workBuffer;
-    context->workBuffer++;
-    context->commandLength--;
-    return data;
-}
-
-static void processHiveVote(txProcessingContext_t *context) {
-    context->content->argumentCount = 4;
-    strcpy(context->content->opName, "vote");
-}
-
-static void processHiveComment(txProcessingContext_t *context) {
-    context->content->argumentCount = 7;
-    strcpy(context->content->opName, "comment");
-}
-
-static void processHiveTransfer(txProcessingContext_t *context) {
-    context->content->argumentCount = 4;
-    strcpy(context->content->opName, "transfer");
-}
-
-static void processHiveTransferToVesting(txProcessingContext_t *context) {
-    context->content->argumentCount = 3;
-    strcpy(context->content->opName, "transfer_to_vesting");
-}
-
-static void processHiveWithdrawVesting(txProcessingContext_t *context) {
-    context->content->argumentCount = 2;
-    strcpy(context->content->opName, "withdraw_vesting");
-}
-
-static void processHiveLimitOrderCreate(txProcessingContext_t *context) {
-    context->content->argumentCount = 6;
-    strcpy(context->content->opName, "limit_order_create");
-}
-
-static void processHiveLimitOrderCancel(txProcessingContext_t *context) {
-    context->content->argumentCount = 2;
-    strcpy(context->content->opName, "limit_order_cancel");
-}
-
-static void processHiveFeedPublish(txProcessingContext_t *context) {
-    context->content->argumentCount = 3;
-    strcpy(context->content->opName, "feed_publish");
-}
-
-static void processHiveConvert(txProcessingContext_t *context) {
-    context->content->argumentCount = 3;
-    strcpy(context->content->opName, "convert");
-}
-
-static void processHiveAccountCreate(txProcessingContext_t *context) {
-    context->content->argumentCount = 8;
-    strcpy(context->content->opName, "account_create");
-}
-
-static void processHiveAccountUpdate(txProcessingContext_t *context) {
-    context->content->argumentCount = 7;
-    strcpy(context->content->opName, "account_update");
-}
-
-static void processHiveWitnessUpdate(txProcessingContext_t *context) {
-    context->content->argumentCount = 4;
-    strcpy(context->content->opName, "witness_update");
-}
-
-static void processHiveAccountWitnessVote(txProcessingContext_t *context) {
-    context->content->argumentCount = 3;
-    strcpy(context->content->opName, "account_witness_vote");
-}
-
-static void processHiveAccountWitnessProxy(txProcessingContext_t *context) {
-    context->content->argumentCount = 2;
-    strcpy(context->content->opName, "account_witness_proxy");
-}
-
-static void processHiveDeleteComment(txProcessingContext_t *context) {
-    context->content->argumentCount = 2;
-    strcpy(context->content->opName, "delete_comment");
-}
-
-static void processHiveCustomJson(txProcessingContext_t *context) {
-    context->content->argumentCount = 4;
-    strcpy(context->content->opName, "custom_json");
+    context->templated = (template != NULL);
+    if (template != NULL) {
+        template_init(&context->templateStream, template);
+    }
+    cx_sha256_init(context->sha256);
 }
 
-static void processHiveCommentOptions(txProcessingContext_t *context) {
-    context->content->argumentCount = 7;
-    strcpy(context->content->opName, "comment_options");
+uint8_t pendingOperations(txProcessingContext_t *context) {
+    return context->slotCount;
 }
 
-static void processHiveSetWithdrawVestingRoute(txProcessingContext_t *context) {
-    context->content->argumentCount = 3;
-    strcpy(context->content->opName, "set_withdraw_vesting_route");
+/**
+ * True while the next operation to review is still being received and
+ * can already be displayed.
+*/
+bool partialOperation(txProcessingContext_t *context) {
+    return context->slotCount == 0 && context->state == TLV_OPERATION_DATA &&
+           context->processingField && context->slots[context->slotHead].partial;
 }
 
-static void processHiveClaimAccount(txProcessingContext_t *context) {
-    context->content->argumentCount = 2;
-    strcpy(context->content->opName, "claim_account");
+/**
+ * Oldest staged operation, the one the user is reviewing.
+*/
+operationSlot_t *reviewedOperation(txProcessingContext_t *context) {
+    if (context->slotCount == 0 && !partialOperation(context)) {
+        THROW(EXCEPTION);
+    }
+    return &context->slots[context->slotHead];
 }
 
-static void processHiveCreateClaimedAccount(txProcessingContext_t *context) {
-    context->content->argumentCount = 7;
-    strcpy(context->content->opName, "create_claimed_account");
+/**
+ * Free the reviewed operation slot once it has been accepted.
+*/
+void releaseOperation(txProcessingContext_t *context) {
+    if (context->slotCount == 0) {
+        THROW(EXCEPTION);
+    }
+    context->slotHead = (context->slotHead + 1) % OPERATION_SLOTS;
+    context->slotCount--;
 }
 
-static void processHiveRequestAccountRecovery(txProcessingContext_t *context) {
-    context->content->argumentCount = 3;
-    strcpy(context->content->opName, "request_account_recovery");
+/**
+ * Slot the next operation is written to while it is received.
+*/
+static operationSlot_t *stagingOperation(txProcessingContext_t *context) {
+    if (context->slotCount == OPERATION_SLOTS) {
+        PRINTF("no free operation slot\n");
+        THROW(EXCEPTION);
+    }
+    return &context->slots[(context->slotHead + context->slotCount) % OPERATION_SLOTS];
 }
 
-static void processHiveRecoverAccount(txProcessingContext_t *context) {
-    context->content->argumentCount = 3;
-    strcpy(context->content->opName, "recover_account");
+/**
+ * Drop the transaction being streamed, further chunks are refused
+ * until signing starts again.
+*/
+void abortTx(txProcessingContext_t *context) {
+    context->state = TLV_NONE;
+    context->slotCount = 0;
+    cursor_init(&context->command, NULL, 0);
+    cursor_init(&context->wire, NULL, 0);
 }
 
-static void processHiveChangeRecoveryAccount(txProcessingContext_t *context) {
-    context->content->argumentCount = 2;
-    strcpy(context->content->opName, "change_recovery_account");
-}
+/**
+ * Compressed commands are inflated right before being parsed and hashed,
+ * a window at a time, templated ones are expanded a segment at a time.
+ * The command then reads the resulting bytes.
+ * Returns false once the received data is exhausted.
+*/
+static bool fillCommand(txProcessingContext_t *context) {
+    uint8_t *inflated;
+    uint32_t length;
 
-static void processHiveTransferToSavings(txProcessingContext_t *context) {
-    context->content->argumentCount = 4;
-    strcpy(context->content->opName, "transfer_to_savings");
+    if (cursor_remaining(&context->command) != 0) {
+        return true;
+    }
+    if (context->compressed) {
+        length = lz_inflate(&context->lz, &context->wire, &inflated);
+    } else if (context->templated) {
+        length = template_expand(&context->templateStream, &context->wire, &inflated);
+    } else {
+        return false;
+    }
+    cursor_init(&context->command, inflated, length);
+    return length != 0;
 }
 
-static void processHiveTransferFromSavings(txProcessingContext_t *context) {
-    context->content->argumentCount = 5;
-    strcpy(context->content->opName, "transfer_from_savings");
+uint8_t readTxByte(txProcessingContext_t *context) {
+    return cursor_read_u8(&context->command);
 }
 
-static void processHiveCancelTransferFromSavings(txProcessingContext_t *context) {
-    context->content->argumentCount = 2;
-    strcpy(context->content->opName, "cancel_transfer_from_savings");
+/**
+ * Take as much of the current field as the command holds.
+*/
+static uint8_t *readFieldChunk(txProcessingContext_t *context, uint32_t *length) {
+    uint32_t left = context->currentFieldLength - context->currentFieldPos;
+    *length = (cursor_remaining(&context->command) < left ? cursor_remaining(&context->command) : left);
+    return cursor_read_bytes(&context->command, *length);
 }
 
-static void processHiveDeclineVotingRights(txProcessingContext_t *context) {
-    context->content->argumentCount = 2;
-    strcpy(context->content->opName, "decline_voting_rights");
+/**
+ * Size fields are cached until complete, then decoded as a varint.
+*/
+static uint32_t readSizeBuffer(txProcessingContext_t *context) {
+    cursor_t cursor;
+    cursor_init(&cursor, context->sizeBuffer, context->currentFieldPos);
+    return cursor_read_varint(&cursor);
 }
 
-static void processHiveResetAccount(txProcessingContext_t *context) {
-    context->content->argumentCount = 3;
-    strcpy(context->content->opName, "reset_account");
-}
+typedef void (*operationParser_t)(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
+typedef uint8_t (*pagedOperationParser_t)(uint8_t *buffer, uint32_t bufferLength, uint8_t argNum, actionArgument_t *arg);
 
-static void processHiveSetResetAccount(txProcessingContext_t *context) {
-    context->content->argumentCount = 3;
-    strcpy(context->content->opName, "set_reset_account");
-}
+/**
+ * Operations with authorities have a paged decoder instead, their
+ * argument count depends on the data.
+*/
+typedef struct hiveOperation_t {
+    uint8_t opType;
+    uint8_t argumentCount;
+    const char *name;
+    operationParser_t parse;
+    pagedOperationParser_t parsePaged;
+} hiveOperation_t;
 
-static void processHiveClaimRewardBalance(txProcessingContext_t *context) {
-    context->content->argumentCount = 4;
-    strcpy(context->content->opName, "claim_reward_balance");
-}
+/**
+ * Operations compiled into the app, see HIVE_OPS in the Makefile.
+*/
+static const hiveOperation_t hiveOperations[] = {
+#ifdef HAVE_HIVE_OP_VOTE
+    {0, 4, "vote", parseHiveVote},
+#endif
+#ifdef HAVE_HIVE_OP_COMMENT
+    {1, 7, "comment", parseHiveComment},
+#endif
+#ifdef HAVE_HIVE_OP_TRANSFER
+    {2, 4, "transfer", parseHiveTransfer},
+#endif
+#ifdef HAVE_HIVE_OP_TRANSFER_TO_VESTING
+    {3, 3, "transfer_to_vesting", parseHiveTransferToVesting},
+#endif
+#ifdef HAVE_HIVE_OP_WITHDRAW_VESTING
+    {4, 2, "withdraw_vesting", parseHiveWithdrawVesting},
+#endif
+#ifdef HAVE_HIVE_OP_LIMIT_ORDER_CREATE
+    {5, 6, "limit_order_create", parseHiveLimitOrderCreate},
+#endif
+#ifdef HAVE_HIVE_OP_LIMIT_ORDER_CANCEL
+    {6, 2, "limit_order_cancel", parseHiveLimitOrderCancel},
+#endif
+#ifdef HAVE_HIVE_OP_FEED_PUBLISH
+    {7, 3, "feed_publish", parseHiveFeedPublish},
+#endif
+#ifdef HAVE_HIVE_OP_CONVERT
+    {8, 3, "convert", parseHiveConvert},
+#endif
+#ifdef HAVE_HIVE_OP_ACCOUNT_CREATE
+    {9, 0, "account_create", NULL, parseHiveAccountCreate},
+#endif
+#ifdef HAVE_HIVE_OP_ACCOUNT_UPDATE
+    {10, 0, "account_update", NULL, parseHiveAccountUpdate},
+#endif
+#ifdef HAVE_HIVE_OP_WITNESS_UPDATE
+    {11, 5, "witness_update", parseHiveWitnessUpdate},
+#endif
+#ifdef HAVE_HIVE_OP_ACCOUNT_WITNESS_VOTE
+    {12, 3, "account_witness_vote", parseHiveAccountWitnessVote},
+#endif
+#ifdef HAVE_HIVE_OP_ACCOUNT_WITNESS_PROXY
+    {13, 2, "account_witness_proxy", parseHiveAccountWitnessProxy},
+#endif
+#ifdef HAVE_HIVE_OP_DELETE_COMMENT
+    {17, 2, "delete_comment", parseHiveDeleteComment},
+#endif
+#ifdef HAVE_HIVE_OP_CUSTOM_JSON
+    {18, 0, "custom_json", NULL, parseHiveCustomJson},
+#endif
+#ifdef HAVE_HIVE_OP_COMMENT_OPTIONS
+    {19, 7, "comment_options", parseHiveCommentOptions},
+#endif
+#ifdef HAVE_HIVE_OP_SET_WITHDRAW_VESTING_ROUTE
+    {20, 4, "set_withdraw_vesting_route", parseHiveSetWithdrawVestingRoute},
+#endif
+#ifdef HAVE_HIVE_OP_CLAIM_ACCOUNT
+    {22, 2, "claim_account", parseHiveClaimAccount},
+#endif
+#ifdef HAVE_HIVE_OP_CREATE_CLAIMED_ACCOUNT
+    {23, 0, "create_claimed_account", NULL, parseHiveCreateClaimedAccount},
+#endif
+#ifdef HAVE_HIVE_OP_REQUEST_ACCOUNT_RECOVERY
+    {24, 0, "request_account_recovery", NULL, parseHiveRequestAccountRecovery},
+#endif
+#ifdef HAVE_HIVE_OP_RECOVER_ACCOUNT
+    {25, 0, "recover_account", NULL, parseHiveRecoverAccount},
+#endif
+#ifdef HAVE_HIVE_OP_CHANGE_RECOVERY_ACCOUNT
+    {26, 2, "change_recovery_account", parseHiveChangeRecoveryAccount},
+#endif
+#ifdef HAVE_HIVE_OP_TRANSFER_TO_SAVINGS
+    {32, 4, "transfer_to_savings", parseHiveTransferToSavings},
+#endif
+#ifdef HAVE_HIVE_OP_TRANSFER_FROM_SAVINGS
+    {33, 5, "transfer_from_savings", parseHiveTransferFromSavings},
+#endif
+#ifdef HAVE_HIVE_OP_CANCEL_TRANSFER_FROM_SAVINGS
+    {34, 2, "cancel_transfer_from_savings", parseHiveCancelTransferFromSavings},
+#endif
+#ifdef HAVE_HIVE_OP_DECLINE_VOTING_RIGHTS
+    {36, 2, "decline_voting_rights", parseHiveDeclineVotingRights},
+#endif
+#ifdef HAVE_HIVE_OP_RESET_ACCOUNT
+    {37, 0, "reset_account", NULL, parseHiveResetAccount},
+#endif
+#ifdef HAVE_HIVE_OP_SET_RESET_ACCOUNT
+    {38, 3, "set_reset_account", parseHiveSetResetAccount},
+#endif
+#ifdef HAVE_HIVE_OP_CLAIM_REWARD_BALANCE
+    {39, 4, "claim_reward_balance", parseHiveClaimRewardBalance},
+#endif
+#ifdef HAVE_HIVE_OP_DELEGATE_VESTING_SHARES
+    {40, 3, "delegate_vesting_shares", parseHiveDelegateVestingShares},
+#endif
+#ifdef HAVE_HIVE_OP_CREATE_PROPOSAL
+    {44, 7, "create_proposal", parseHiveCreateProposal},
+#endif
+#ifdef HAVE_HIVE_OP_UPDATE_PROPOSAL_VOTES
+    {45, 3, "update_proposal_votes", parseHiveUpdateProposalVotes},
+#endif
+#ifdef HAVE_HIVE_OP_REMOVE_PROPOSAL
+    {46, 2, "remove_proposal", parseHiveRemoveProposal},
+#endif
+};
 
-static void processHiveDelegateVestingShares(txProcessingContext_t *context) {
-    context->content->argumentCount = 3;
-    strcpy(context->content->opName, "delegate_vesting_shares");
+static const hiveOperation_t *findOperation(uint8_t opType) {
+    for (uint32_t i = 0; i < sizeof(hiveOperations) / sizeof(hiveOperations[0]); ++i) {
+        if (hiveOperations[i].opType == opType) {
+            return &hiveOperations[i];
+        }
+    }
+    return NULL;
 }
 
-static void processHiveCreateProposal(txProcessingContext_t *context) {
-    context->content->argumentCount = 7;
-    strcpy(context->content->opName, "create_proposal");
+void printArgument(uint8_t argNum, txProcessingContext_t *context) {
+    printArgumentTo(argNum, context, &context->content->arg);
 }
 
-static void processHiveUpdateProposalVotes(txProcessingContext_t *context) {
-    context->content->argumentCount = 3;
-    strcpy(context->content->opName, "update_proposal_votes");
-}
+/**
+ * Decode one argument of the current operation into any page, so that
+ * pages can be formatted ahead of the one displayed.
+*/
+void printArgumentTo(uint8_t argNum, txProcessingContext_t *context, actionArgument_t *arg) {
+    operationSlot_t *slot = reviewedOperation(context);
+    uint8_t *buffer = slot->data;
+    uint32_t bufferLength = slot->dataLength;
+
+#ifdef HAVE_HIVE_TRANSFER_FAST_PATH
+    // most transactions are a single transfer
+    if (slot->transferIndexed) {
+        printHiveTransferField(buffer, bufferLength, &slot->transfer, argNum, arg);
+        return;
+    }
+#endif
 
-static void processHiveRemoveProposal(txProcessingContext_t *context) {
-    context->content->argumentCount = 2;
-    strcpy(context->content->opName, "remove_proposal");
-}
+    const hiveOperation_t *operation = findOperation(slot->opType);
 
-void printArgument(uint8_t argNum, txProcessingContext_t *context) {
-    uint8_t opType = context->content->opType;
-    uint8_t *buffer = context->actionDataBuffer;
-    uint32_t bufferLength = context->currentActionDataBufferLength;
-    actionArgument_t *arg =  &context->content->arg;
-
-    switch (opType) {
-    case 0:
-        parseHiveVote(buffer, bufferLength, argNum, arg);
-        break;
-    case 1:
-        parseHiveComment(buffer, bufferLength, argNum, arg);
-        break;
-    case 2:
-        parseHiveTransfer(buffer, bufferLength, argNum, arg);
-        break;
-    case 3:
-        parseHiveTransferToVesting(buffer, bufferLength, argNum, arg);
-        break;
-    case 4:
-        parseHiveWithdrawVesting(buffer, bufferLength, argNum, arg);
-        break;
-    case 5:
-        parseHiveLimitOrderCreate(buffer, bufferLength, argNum, arg);
-        break;
-    case 6:
-        parseHiveLimitOrderCancel(buffer, bufferLength, argNum, arg);
-        break;
-    case 7:
-        parseHiveFeedPublish(buffer, bufferLength, argNum, arg);
-        break;
-    case 8:
-        parseHiveConvert(buffer, bufferLength, argNum, arg);
-        break;
-    case 9:
-        parseHiveAccountCreate(buffer, bufferLength, argNum, arg);
-        break;
-    case 10:
-        parseHiveAccountUpdate(buffer, bufferLength, argNum, arg);
-        break;
-    case 11:
-        parseHiveWitnessUpdate(buffer, bufferLength, argNum, arg);
-        break;
-    case 12:
-        parseHiveAccountWitnessVote(buffer, bufferLength, argNum, arg);
-        break;
-    case 13:
-        parseHiveAccountWitnessProxy(buffer, bufferLength, argNum, arg);
-        break;
-    case 17:
-        parseHiveDeleteComment(buffer, bufferLength, argNum, arg);
-        break;
-    case 18:
-        parseHiveCustomJson(buffer, bufferLength, argNum, arg);
-        break;
-    case 19:
-        parseHiveCommentOptions(buffer, bufferLength, argNum, arg);
-        break;
-    case 20:
-        parseHiveSetWithdrawVestingRoute(buffer, bufferLength, argNum, arg);
-        break;
-    case 22:
-        parseHiveClaimAccount(buffer, bufferLength, argNum, arg);
-        break;
-    case 23:
-        parseHiveCreateClaimedAccount(buffer, bufferLength, argNum, arg);
-        break;
-    case 24:
-        parseHiveRequestAccountRecovery(buffer, bufferLength, argNum, arg);
-        break;
-    case 25:
-        parseHiveRecoverAccount(buffer, bufferLength, argNum, arg);
-        break;
-    case 26:
-        parseHiveChangeRecoveryAccount(buffer, bufferLength, argNum, arg);
-        break;
-    case 32:
-        parseHiveTransferToSavings(buffer, bufferLength, argNum, arg);
-        break;
-    case 33:
-        parseHiveTransferFromSavings(buffer, bufferLength, argNum, arg);
-        break;
-    case 34:
-        parseHiveCancelTransferFromSavings(buffer, bufferLength, argNum, arg);
-        break;
-    case 36:
-        parseHiveDeclineVotingRights(buffer, bufferLength, argNum, arg);
-        break;
-    case 37:
-        parseHiveResetAccount(buffer, bufferLength, argNum, arg);
-        break;
-    case 38:
-        parseHiveSetResetAccount(buffer, bufferLength, argNum, arg);
-        break;
-    case 39:
-        parseHiveClaimRewardBalance(buffer, bufferLength, argNum, arg);
-        break;
-    case 40:
-        parseHiveDelegateVestingShares(buffer, bufferLength, argNum, arg);
-        break;
-    case 44:
-        parseHiveCreateProposal(buffer, bufferLength, argNum, arg);
-        break;
-    case 45:
-        parseHiveUpdateProposalVotes(buffer, bufferLength, argNum, arg);
-        break;
-    case 46:
-        parseHiveRemoveProposal(buffer, bufferLength, argNum, arg);
-        break;
-    default:
+    if (operation != NULL && operation->parsePaged != NULL) {
+        if (((pagedOperationParser_t)PIC(operation->parsePaged))(buffer, bufferLength, argNum, arg) != 0) {
+            THROW(EXCEPTION);
+        }
+    } else if (operation != NULL) {
+        ((operationParser_t)PIC(operation->parse))(buffer, bufferLength, argNum, arg);
+    } else if (context->dataAllowed) {
+        parseUnknownAction(buffer, bufferLength, argNum, arg);
+    } else {
         THROW(EXCEPTION);
     }
+}
 
-    return;
+static void flushTxHash(txProcessingContext_t *context) {
+    if (context->hashStagingLength != 0) {
+        cx_hash(&context->sha256->header, 0, context->hashStaging, context->hashStagingLength, NULL, 0);
+#ifdef HAVE_PRINTF
+        context->hashCalls++;
+#endif
+        context->hashStagingLength = 0;
+    }
 }
 
 /**
  * Sequentially hash an incoming data.
  * Hash functionality is moved out here in order to reduce 
  * dependencies on specific hash implementation.
+ * Fields are separated by their TLV header, which is not hashed, so the
+ * many small header fields are gathered and hashed with a single call.
 */
 static void hashTxData(txProcessingContext_t *context, uint8_t *buffer, uint32_t length) {
-    cx_hash(&context->sha256->header, 0, buffer, length, NULL, 0);
-}
-
-static void hashActionData(txProcessingContext_t *context, uint8_t *buffer, uint32_t length) {
-    cx_hash(&context->dataSha256->header, 0, buffer, length, NULL, 0);
+#ifdef HAVE_PRINTF
+    context->hashFragments++;
+#endif
+    if (context->hashStagingLength + length > sizeof(context->hashStaging)) {
+        flushTxHash(context);
+    }
+    if (length >= sizeof(context->hashStaging)) {
+        cx_hash(&context->sha256->header, 0, buffer, length, NULL, 0);
+#ifdef HAVE_PRINTF
+        context->hashCalls++;
+#endif
+        return;
+    }
+    os_memmove(context->hashStaging + context->hashStagingLength, buffer, length);
+    context->hashStagingLength += length;
 }
 
 /**
@@ -360,16 +361,11 @@ static void hashActionData(txProcessingContext_t *context, uint8_t *buffer, uint
 */
 static void processField(txProcessingContext_t *context) {
     if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t length = 
-            (context->commandLength <
-                     ((context->currentFieldLength - context->currentFieldPos))
-                ? context->commandLength
-                : context->currentFieldLength - context->currentFieldPos);
+        uint32_t length;
+        uint8_t *data = readFieldChunk(context, &length);
 
-        hashTxData(context, context->workBuffer, length);
+        hashTxData(context, data, length);
 
-        context->workBuffer += length;
-        context->commandLength -= length;
         context->currentFieldPos += length;
     }
 
@@ -386,27 +382,25 @@ static void processField(txProcessingContext_t *context) {
  * Throw exception if number is not '0'.
 */
 static void processZeroSizeField(txProcessingContext_t *context) {
+    if (context->currentFieldLength > sizeof(context->sizeBuffer)) {
+        PRINTF("size field overflow\n");
+        THROW(EXCEPTION);
+    }
+
     if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t length = 
-            (context->commandLength <
-                     ((context->currentFieldLength - context->currentFieldPos))
-                ? context->commandLength
-                : context->currentFieldLength - context->currentFieldPos);
+        uint32_t length;
+        uint8_t *data = readFieldChunk(context, &length);
 
-        hashTxData(context, context->workBuffer, length);
+        hashTxData(context, data, length);
 
         // Store data into a buffer
-        os_memmove(context->sizeBuffer + context->currentFieldPos, context->workBuffer, length);
+        os_memmove(context->sizeBuffer + context->currentFieldPos, data, length);
 
-        context->workBuffer += length;
-        context->commandLength -= length;
         context->currentFieldPos += length;
     }
 
     if (context->currentFieldPos == context->currentFieldLength) {
-        uint32_t sizeValue = 0;
-        unpack_variant32(context->sizeBuffer, context->currentFieldPos + 1, &sizeValue);
-        if (sizeValue != 0) {
+        if (readSizeBuffer(context) != 0) {
             PRINTF("zeroSizeField must be 0\n");
             THROW(EXCEPTION);
         }
@@ -425,25 +419,25 @@ static void processZeroSizeField(txProcessingContext_t *context) {
  * do additional processing: Read actual number of actions encoded in buffer.
 */
 static void processActionListSizeField(txProcessingContext_t *context) {
+    if (context->currentFieldLength > sizeof(context->sizeBuffer)) {
+        PRINTF("size field overflow\n");
+        THROW(EXCEPTION);
+    }
+
     if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t length = 
-            (context->commandLength <
-                     ((context->currentFieldLength - context->currentFieldPos))
-                ? context->commandLength
-                : context->currentFieldLength - context->currentFieldPos);
+        uint32_t length;
+        uint8_t *data = readFieldChunk(context, &length);
 
-        hashTxData(context, context->workBuffer, length);
+        hashTxData(context, data, length);
 
         // Store data into a buffer
-        os_memmove(context->sizeBuffer + context->currentFieldPos, context->workBuffer, length);
+        os_memmove(context->sizeBuffer + context->currentFieldPos, data, length);
 
-        context->workBuffer += length;
-        context->commandLength -= length;
         context->currentFieldPos += length;
     }
 
     if (context->currentFieldPos == context->currentFieldLength) {
-        unpack_variant32(context->sizeBuffer, context->currentFieldPos + 1, &context->numOperations);
+        context->numOperations = readSizeBuffer(context);
         context->currentOpIndex = 0;
         
         // Reset size buffer
@@ -457,149 +451,112 @@ static void processActionListSizeField(txProcessingContext_t *context) {
     }
 }
 
+/**
+ * Operations with a fixed argument count are reviewed while they are
+ * received, their fields are decoded as their bytes come in. Paged and
+ * unknown operations need all of their data to be laid out.
+*/
+static void preparePartialOperation(txProcessingContext_t *context, operationSlot_t *slot) {
+    if (!slot->partial) {
+        const hiveOperation_t *operation = findOperation(slot->opType);
+        if (operation == NULL || operation->parse == NULL) {
+            return;
+        }
+        slot->argumentCount = operation->argumentCount;
+        strcpy(slot->opName, (const char *)PIC(operation->name));
+        slot->opIndex = context->currentOpIndex + 1;
+        slot->partial = true;
+    }
+    slot->dataLength = context->currentFieldPos;
+    context->actionUpdated = true;
+}
+
+/**
+ * Decode every field once the operation is received, so that a malformed
+ * one is refused before it is displayed rather than on one of its pages.
+*/
+static void validateOperation(operationSlot_t *slot, const hiveOperation_t *operation) {
+    actionArgument_t arg;
+
+    if (operation->parsePaged != NULL) {
+        for (uint8_t page = 0; page < slot->argumentCount; ++page) {
+            ((pagedOperationParser_t)PIC(operation->parsePaged))(slot->data, slot->dataLength, page, &arg);
+        }
+    } else {
+        ((operationParser_t)PIC(operation->parse))(slot->data, slot->dataLength, ARGUMENT_VALIDATE, &arg);
+    }
+}
+
 /**
  * Process current action data field and store in into data buffer.
 */
 static void processActionData(txProcessingContext_t *context) {
-    if (context->currentFieldLength > sizeof(context->actionDataBuffer) - 1) {
+    operationSlot_t *slot = stagingOperation(context);
+
+    if (context->currentFieldLength > sizeof(slot->data) - 1) {
         PRINTF("processActionData data overflow\n");
         THROW(EXCEPTION);
     }
 
     if (context->currentFieldPos < context->currentFieldLength) {
-        uint32_t length = 
-            (context->commandLength <
-                     ((context->currentFieldLength - context->currentFieldPos))
-                ? context->commandLength
-                : context->currentFieldLength - context->currentFieldPos);
-
-        hashTxData(context, context->workBuffer, length);
-        hashActionData(context, context->workBuffer, length);
-        os_memmove(context->actionDataBuffer + context->currentFieldPos, context->workBuffer, length);
+        uint32_t length;
+        uint8_t *data = readFieldChunk(context, &length);
+
+        // the header ended with the chunk, the type comes with the next one
+        if (length == 0) {
+            return;
+        }
+        hashTxData(context, data, length);
+        os_memmove(slot->data + context->currentFieldPos, data, length);
         if(context->currentFieldPos == 0) {
-            os_memmove(&context->content->opType, context->workBuffer, sizeof(uint8_t));
+            slot->opType = data[0];
+            slot->partial = false;
+            slot->transferIndexed = false;
         }
 
-        context->workBuffer += length;
-        context->commandLength -= length;
         context->currentFieldPos += length;
+        if (context->currentFieldPos < context->currentFieldLength) {
+            preparePartialOperation(context, slot);
+        }
     }
 
     if (context->currentFieldPos == context->currentFieldLength) {
-        context->currentActionDataBufferLength = context->currentFieldLength;
-
-        switch(context->content->opType) {
-            case 0:
-                processHiveVote(context);
-                break;
-            case 1:
-                processHiveComment(context);
-                break;
-            case 2:
-                processHiveTransfer(context);
-                break;
-            case 3:
-                processHiveTransferToVesting(context);
-                break;
-            case 4:
-                processHiveWithdrawVesting(context);
-                break;
-            case 5:
-                processHiveLimitOrderCreate(context);
-                break;
-            case 6:
-                processHiveLimitOrderCancel(context);
-                break;
-            case 7:
-                processHiveFeedPublish(context);
-                break;
-            case 8:
-                processHiveConvert(context);
-                break;
-            case 9:
-                processHiveAccountCreate(context);
-                break;
-            case 10:
-                processHiveAccountUpdate(context);
-                break;
-            case 11:
-                processHiveWitnessUpdate(context);
-                break;
-            case 12:
-                processHiveAccountWitnessVote(context);
-                break;
-            case 13:
-                processHiveAccountWitnessProxy(context);
-                break;
-            case 17:
-                processHiveDeleteComment(context);
-                break;
-            case 18:
-                processHiveCustomJson(context);
-                break;
-            case 19:
-                processHiveCommentOptions(context);
-                break;
-            case 20:
-                processHiveSetWithdrawVestingRoute(context);
-                break;
-            case 22:
-                processHiveClaimAccount(context);
-                break;
-            case 23:
-                processHiveCreateClaimedAccount(context);
-                break;
-            case 24:
-                processHiveRequestAccountRecovery(context);
-                break;
-            case 25:
-                processHiveRecoverAccount(context);
-                break;
-            case 26:
-                processHiveChangeRecoveryAccount(context);
-                break;
-            case 32:
-                processHiveTransferToSavings(context);
-                break;
-            case 33:
-                processHiveTransferFromSavings(context);
-                break;
-            case 34:
-                processHiveCancelTransferFromSavings(context);
-                break;
-            case 36:
-                processHiveDeclineVotingRights(context);
-                break;
-            case 37:
-                processHiveResetAccount(context);
-                break;
-            case 38:
-                processHiveSetResetAccount(context);
-                break;
-            case 39:
-                processHiveClaimRewardBalance(context);
-                break;
-            case 40:
-                processHiveDelegateVestingShares(context);
-                break;
-            case 44:
-                processHiveCreateProposal(context);
-                break;
-            case 45:
-                processHiveUpdateProposalVotes(context);
-                break;
-            case 46:
-                processHiveRemoveProposal(context);
-                break;
-            default:
-                PRINTF("unknown action");
-                THROW(EXCEPTION);
+        slot->dataLength = context->currentFieldLength;
+        slot->partial = false;
+
+        const hiveOperation_t *operation = findOperation(slot->opType);
+        if (operation != NULL && operation->parsePaged != NULL) {
+            // walks the authorities once, without formatting their entries
+            actionArgument_t arg;
+            slot->argumentCount = ((pagedOperationParser_t)PIC(operation->parsePaged))(
+                slot->data, slot->dataLength, ARGUMENT_COUNT_QUERY, &arg);
+            strcpy(slot->opName, (const char *)PIC(operation->name));
+            validateOperation(slot, operation);
+        } else if (operation != NULL) {
+            slot->argumentCount = operation->argumentCount;
+            strcpy(slot->opName, (const char *)PIC(operation->name));
+            validateOperation(slot, operation);
+#ifdef HAVE_HIVE_TRANSFER_FAST_PATH
+            if (isHiveTransfer(slot->opType)) {
+                slot->transferIndexed = indexHiveTransfer(slot->data, slot->dataLength, &slot->transfer);
+            }
+#endif
+        } else if (context->dataAllowed) {
+            // not compiled in, reviewed as arbitrary data
+            slot->argumentCount = 3;
+            strcpy(slot->opName, "unknown");
+        } else {
+            PRINTF("unknown action");
+            THROW(EXCEPTION);
         }
 
-        if (++context->currentOpIndex >= context->numOperations) {
+        slot->opIndex = ++context->currentOpIndex;
+        context->slotCount++;
+        if (context->currentOpIndex >= context->numOperations) {
             context->state = TLV_TX_EXTENSION_LIST_SIZE;
         }
-        
+
+
         context->processingField = false;
         context->actionReady = true;
     }
@@ -615,16 +572,35 @@ static parserStatus_e processTxInternal(txProcessingContext_t *context) {
             context->actionReady = false;
             return STREAM_ACTION_READY;
         }
+        if (context->actionUpdated) {
+            context->actionUpdated = false;
+            return STREAM_ACTION_UPDATED;
+        }
         if (context->state == TLV_DONE) {
+            if (context->compressed && (!lz_idle(&context->lz) || cursor_remaining(&context->wire) != 0)) {
+                PRINTF("Trailing compressed data\n");
+                return STREAM_FAULT;
+            }
+            if (context->templated && (!template_done(&context->templateStream) || cursor_remaining(&context->wire) != 0)) {
+                PRINTF("Template not matching the transaction\n");
+                return STREAM_FAULT;
+            }
+            // the digest is finalized next
+            flushTxHash(context);
             return STREAM_FINISHED;
         }
-        if (context->commandLength == 0) {
+        if (!fillCommand(context)) {
             return STREAM_PROCESSING;
         }
+        if (context->state == TLV_OPERATION_DATA && !context->processingField &&
+            context->slotCount == OPERATION_SLOTS) {
+            // wait for the user to accept a staged operation
+            return STREAM_QUEUE_FULL;
+        }
         if (!context->processingField) {
             // While we are not processing a field, we should TLV parameters
             bool decoded = false;
-            while (context->commandLength != 0) {
+            while (cursor_remaining(&context->command) != 0) {
                 bool valid;
                 // Feed the TLV buffer until the length can be decoded
                 context->tlvBuffer[context->tlvBufferPos++] =
@@ -649,7 +625,8 @@ static parserStatus_e processTxInternal(txProcessingContext_t *context) {
                 }
             }
             if (!decoded) {
-                return STREAM_PROCESSING;
+                // more may be inflated from the command
+                continue;
             }
             context->currentFieldPos = 0;
             context->tlvBufferPos = 0;
@@ -732,20 +709,35 @@ static parserStatus_e processTxInternal(txProcessingContext_t *context) {
  * TX_EXTENSION_NUMBER theoretically is not fixed due to serialization. Ledger accepts only 0 as encoded value.
  * CTX_FREE_ACTION_DATA_NUMBER theoretically is not fixed due to serialization. Ledger accepts only 0 as encoded value.
 */
+/**
+ * A new command is only taken once the held one is fully parsed.
+*/
+static void loadCommand(txProcessingContext_t *context, uint8_t *buffer, uint32_t length) {
+    if (context->compressed || context->templated) {
+        if (cursor_remaining(&context->wire) == 0) {
+            cursor_init(&context->wire, buffer, length);
+        }
+    } else if (cursor_remaining(&context->command) == 0) {
+        cursor_init(&context->command, buffer, length);
+    }
+#ifdef HAVE_PRINTF
+    if (buffer != NULL) {
+        context->hashFragments = 0;
+        context->hashCalls = 0;
+    }
+#endif
+}
+
 parserStatus_e parseTx(txProcessingContext_t *context, uint8_t *buffer, uint32_t length) {
     parserStatus_e result;
 #ifdef DEBUG_APP
     // Do not catch exceptions.
-    context->workBuffer = buffer;
-    context->commandLength = length;
+    loadCommand(context, buffer, length);
     result = processTxInternal(context);
 #else
     BEGIN_TRY {
         TRY {
-            if (context->commandLength == 0) {
-                context->workBuffer = buffer;
-                context->commandLength = length;
-            }
+            loadCommand(context, buffer, length);
             result = processTxInternal(context);
         }
         CATCH_OTHER(e) {
@@ -755,6 +747,11 @@ parserStatus_e parseTx(txProcessingContext_t *context, uint8_t *buffer, uint32_t
         }
     }
     END_TRY;
+#endif
+#ifdef HAVE_PRINTF
+    if (result == STREAM_PROCESSING || result == STREAM_FINISHED) {
+        PRINTF("Command hashed: %d fields in %d calls\n", context->hashFragments, context->hashCalls);
+    }
 #endif
     return result;
 }
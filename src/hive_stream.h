@@ -23,6 +23,10 @@
 #include <stdbool.h>
 #include "hive_types.h"
 #include "hive_parse.h"
+#include "hive_parse_operations.h"
+#include "hive_cursor.h"
+#include "hive_lz.h"
+#include "hive_template.h"
 
 typedef struct txProcessingContent_t {
     uint8_t opType;
@@ -31,6 +35,34 @@ typedef struct txProcessingContent_t {
     actionArgument_t arg;
 } txProcessingContent_t;
 
+/**
+ * Operations are staged in a small queue, so the next one can be
+ * received and hashed while the current one is still being reviewed.
+ * The Nano S keeps a single slot for lack of RAM.
+*/
+#if defined(TARGET_NANOX)
+#define OPERATION_SLOTS 2
+#else
+#define OPERATION_SLOTS 1
+#endif
+
+// small fields are gathered up to this size before being hashed
+#define HASH_STAGING_SIZE 64
+
+typedef struct operationSlot_t {
+    uint8_t opType;
+    char argumentCount;
+    char opName[32];
+    uint32_t opIndex;
+    // still being received, dataLength bytes are in so far
+    bool partial;
+    // transfer fields located once staged, see HAVE_HIVE_TRANSFER_FAST_PATH
+    bool transferIndexed;
+    transferFields_t transfer;
+    uint32_t dataLength;
+    uint8_t data[512];
+} operationSlot_t;
+
 typedef enum txProcessingState_e {
     TLV_NONE = 0x0, 
     TLV_CHAIN_ID = 0x1,
@@ -46,22 +78,34 @@ typedef enum txProcessingState_e {
 typedef struct txProcessingContext_t {
     txProcessingState_e state;
     bool actionReady;
+    bool actionUpdated;
     bool confirmProcessing;
     cx_sha256_t *sha256;
-    cx_sha256_t *dataSha256;
     uint32_t currentFieldLength;
     uint32_t currentFieldPos;
     uint32_t currentOpIndex;
     uint32_t numOperations;
     char currentOpType;
-    uint32_t currentActionDataBufferLength;
     bool processingField;
     uint8_t tlvBuffer[5];
     uint32_t tlvBufferPos;
-    uint8_t *workBuffer;
-    uint32_t commandLength;
+    cursor_t command;
+    uint8_t hashStaging[HASH_STAGING_SIZE];
+    uint8_t hashStagingLength;
+#ifdef HAVE_PRINTF
+    // per command, shown in debug builds
+    uint16_t hashFragments;
+    uint16_t hashCalls;
+#endif
+    bool compressed;
+    cursor_t wire;
+    lzStream_t lz;
+    bool templated;
+    templateStream_t templateStream;
     uint8_t sizeBuffer[12];
-    uint8_t actionDataBuffer[512];
+    operationSlot_t slots[OPERATION_SLOTS];
+    uint8_t slotHead;
+    uint8_t slotCount;
     uint8_t dataAllowed;
     txProcessingContent_t *content;
 } txProcessingContext_t;
@@ -72,17 +116,27 @@ typedef enum parserStatus_e {
     STREAM_ACTION_READY,
     STREAM_CONFIRM_PROCESSING,
     STREAM_FINISHED,
+    STREAM_QUEUE_FULL,
+    STREAM_ACTION_UPDATED,
 } parserStatus_e;
 
 void initTxContext(
     txProcessingContext_t *context, 
     cx_sha256_t *sha256, 
-    cx_sha256_t *dataSha256,
     txProcessingContent_t *processingContent,
-    uint8_t dataAllowed
+    uint8_t dataAllowed,
+    bool compressed,
+    hiveTemplate_t *template
 );
 parserStatus_e parseTx(txProcessingContext_t *context, uint8_t *buffer, uint32_t length);
+void abortTx(txProcessingContext_t *context);
+
+uint8_t pendingOperations(txProcessingContext_t *context);
+bool partialOperation(txProcessingContext_t *context);
+operationSlot_t *reviewedOperation(txProcessingContext_t *context);
+void releaseOperation(txProcessingContext_t *context);
 
 void printArgument(uint8_t argNum, txProcessingContext_t *processingContext);
+void printArgumentTo(uint8_t argNum, txProcessingContext_t *processingContext, actionArgument_t *arg);
 
 #endif // __HIVE_STREAM_H__
@@ -0,0 +1,160 @@
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "os.h"
+#include "hive_template.h"
+
+#define NUMBER_OCTET_STRING 0x04
+// the operation tag always uses a two bytes length
+#define LENGTH_TWO_BYTES 0x82
+#define OP_LIST_SIZE 1
+#define TX_EXTENSION_LIST_SIZE 0
+
+#define STEP_CHAIN_ID 1
+#define STEP_EXPIRATION 7
+#define STEP_OPERATION 8
+#define STEP_SEGMENTS 9
+
+// ref_block_num, ref_block_prefix and expiration
+static const uint8_t headerFieldLength[] = {2, 4, 4};
+
+/**
+ * Read the template request:
+ * [chain id][op type][segment count]([segment length][segment])*
+ * with between 1 and HIVE_TEMPLATE_MAX_FIELDS + 1 segments.
+ * Returns the number of bytes read.
+*/
+uint32_t hive_template_parse(hiveTemplate_t *template, uint8_t *buffer, uint32_t length) {
+    cursor_t cursor;
+    uint8_t opType;
+    uint8_t segmentCount;
+    uint8_t segmentLength;
+    uint8_t i;
+
+    os_memset(template, 0, sizeof(hiveTemplate_t));
+    cursor_init(&cursor, buffer, length);
+
+    os_memmove(template->chainId, cursor_read_bytes(&cursor, HIVE_CHAIN_ID_LENGTH), HIVE_CHAIN_ID_LENGTH);
+    opType = cursor_read_u8(&cursor);
+    segmentCount = cursor_read_u8(&cursor);
+    // operation types are single byte varints
+    if (opType >= 0x80 || segmentCount == 0 || segmentCount > HIVE_TEMPLATE_MAX_FIELDS + 1) {
+        THROW(0x6a80);
+    }
+    template->fieldCount = segmentCount - 1;
+
+    template->segments[template->dataLength++] = opType;
+    for (i = 0; i < segmentCount; i++) {
+        segmentLength = cursor_read_u8(&cursor);
+        if (template->dataLength + segmentLength > HIVE_TEMPLATE_DATA_LENGTH) {
+            PRINTF("Template too large\n");
+            THROW(0x6a84);
+        }
+        os_memmove(template->segments + template->dataLength, cursor_read_bytes(&cursor, segmentLength), segmentLength);
+        template->dataLength += segmentLength;
+        template->segmentLength[i] = segmentLength;
+    }
+    template->segmentLength[0]++;
+    template->used = true;
+
+    return length - cursor_remaining(&cursor);
+}
+
+void template_init(templateStream_t *stream, hiveTemplate_t *template) {
+    os_memset(stream, 0, sizeof(templateStream_t));
+    stream->template = template;
+}
+
+bool template_done(templateStream_t *stream) {
+    // segments and fields, then the extensions
+    return stream->step > STEP_SEGMENTS + 2 * stream->template->fieldCount + 1;
+}
+
+/**
+ * Length of the operation, the fields must all be in the command.
+*/
+static uint32_t operation_length(hiveTemplate_t *template, cursor_t *in) {
+    cursor_t fields = *in;
+    uint32_t length = template->dataLength;
+    uint8_t i;
+
+    for (i = 0; i < template->fieldCount; i++) {
+        uint8_t fieldLength = cursor_read_u8(&fields);
+        cursor_skip(&fields, fieldLength);
+        length += fieldLength;
+    }
+    return length;
+}
+
+/**
+ * Return the next bytes of the expanded transaction, out points to them.
+ * Returns 0 when done or waiting for the next command.
+*/
+uint32_t template_expand(templateStream_t *stream, cursor_t *in, uint8_t **out) {
+    hiveTemplate_t *template = stream->template;
+    uint32_t length = 0;
+    uint8_t step;
+
+    while (length == 0 && !template_done(stream)) {
+        step = stream->step;
+        if (step == STEP_CHAIN_ID) {
+            *out = template->chainId;
+            length = HIVE_CHAIN_ID_LENGTH;
+        } else if (step < STEP_OPERATION && (step & 1) == 0) {
+            stream->scratch[0] = NUMBER_OCTET_STRING;
+            stream->scratch[1] = (step == 0 ? HIVE_CHAIN_ID_LENGTH : headerFieldLength[step / 2 - 1]);
+            *out = stream->scratch;
+            length = 2;
+        } else if (step <= STEP_EXPIRATION) {
+            if (cursor_remaining(in) == 0) {
+                return 0;
+            }
+            length = headerFieldLength[(step - 3) / 2];
+            *out = cursor_read_bytes(in, length);
+        } else if (step == STEP_OPERATION) {
+            uint32_t opLength;
+            if (cursor_remaining(in) == 0) {
+                return 0;
+            }
+            opLength = operation_length(template, in);
+            stream->scratch[0] = NUMBER_OCTET_STRING;
+            stream->scratch[1] = 1;
+            stream->scratch[2] = OP_LIST_SIZE;
+            stream->scratch[3] = NUMBER_OCTET_STRING;
+            stream->scratch[4] = LENGTH_TWO_BYTES;
+            stream->scratch[5] = opLength >> 8;
+            stream->scratch[6] = opLength;
+            *out = stream->scratch;
+            length = 7;
+        } else if (step - STEP_SEGMENTS == 2 * template->fieldCount + 1) {
+            stream->scratch[0] = NUMBER_OCTET_STRING;
+            stream->scratch[1] = 1;
+            stream->scratch[2] = TX_EXTENSION_LIST_SIZE;
+            *out = stream->scratch;
+            length = 3;
+        } else if (((step - STEP_SEGMENTS) & 1) == 0) {
+            *out = template->segments + stream->offset;
+            length = template->segmentLength[(step - STEP_SEGMENTS) / 2];
+            stream->offset += length;
+        } else {
+            length = cursor_read_u8(in);
+            *out = cursor_read_bytes(in, length);
+        }
+        stream->step++;
+    }
+    return length;
+}
@@ -0,0 +1,74 @@
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#ifndef __HIVE_TEMPLATE_H__
+#define __HIVE_TEMPLATE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hive_cursor.h"
+
+#define HIVE_CHAIN_ID_LENGTH 32
+// ref_block_num, ref_block_prefix and expiration
+#define HIVE_TEMPLATE_HEADER_LENGTH 10
+#define HIVE_TEMPLATE_MAX_FIELDS 4
+
+#if defined(TARGET_NANOX)
+#define HIVE_TEMPLATES 4
+#define HIVE_TEMPLATE_DATA_LENGTH 128
+#else
+#define HIVE_TEMPLATES 2
+#define HIVE_TEMPLATE_DATA_LENGTH 64
+#endif
+
+/**
+ * Serialized shape of a single operation transaction, registered once
+ * by the host. The operation is split into fixed segments around up to
+ * HIVE_TEMPLATE_MAX_FIELDS variable fields: a transfer from a given
+ * account keeps the sender fixed and leaves the recipient, amount and
+ * memo variable. Only the wire encoding is shortened, the expanded bytes
+ * are parsed, hashed and reviewed as any transaction.
+*/
+typedef struct hiveTemplate_t {
+    bool used;
+    uint8_t chainId[HIVE_CHAIN_ID_LENGTH];
+    uint8_t fieldCount;
+    // fieldCount + 1 segments, the first one starts with the operation type
+    uint8_t segmentLength[HIVE_TEMPLATE_MAX_FIELDS + 1];
+    uint8_t dataLength;
+    uint8_t segments[HIVE_TEMPLATE_DATA_LENGTH];
+} hiveTemplate_t;
+
+/**
+ * Expansion of a template into the DER framed transaction, with the
+ * header and variable fields read from the received command. Each step
+ * returns one piece: a field tag, template bytes or received bytes.
+*/
+typedef struct templateStream_t {
+    hiveTemplate_t *template;
+    uint8_t step;
+    uint8_t offset;
+    // tags, and the operation count before the operation tag
+    uint8_t scratch[7];
+} templateStream_t;
+
+uint32_t hive_template_parse(hiveTemplate_t *template, uint8_t *buffer, uint32_t length);
+void template_init(templateStream_t *stream, hiveTemplate_t *template);
+uint32_t template_expand(templateStream_t *stream, cursor_t *in, uint8_t **out);
+bool template_done(templateStream_t *stream);
+
+#endif // __HIVE_TEMPLATE_H__
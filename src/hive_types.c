@@ -38,8 +38,16 @@ uint8_t asset_to_string(asset_t *asset, char *out, uint32_t size) {
         THROW(INVALID_PARAMETER);
     }
 
-    char amountSym[sizeof(asset_t)];
-    os_memset(amountSym, 0, sizeof(asset_t));
+    // 20 digits, '.', ' ' and the symbol
+    char amountSym[32];
+    char symbol[sizeof(asset->symbol) + 1];
+    os_memset(amountSym, 0, sizeof(amountSym));
+    os_memset(symbol, 0, sizeof(symbol));
+    os_memmove(symbol, asset->symbol, sizeof(asset->symbol));
+
+    if (asset->precision > 18) {
+        THROW(INVALID_PARAMETER);
+    }
 
     // convert asset amount to string
     i64toa(asset->amount, amountSym);
@@ -51,26 +59,16 @@ uint8_t asset_to_string(asset_t *asset, char *out, uint32_t size) {
 
     append(amountSym, ".", strlen(amountSym) - asset->precision);
     strcat(amountSym, " ");
-    strcat(amountSym, asset->symbol);
+    strcat(amountSym, symbol);
 
-    os_memmove(out, amountSym, sizeof(amountSym));
+    if (strlen(amountSym) >= size) {
+        THROW(EXCEPTION_OVERFLOW);
+    }
+    os_memmove(out, amountSym, strlen(amountSym) + 1);
 
     return strlen(amountSym);
 }
 
-uint32_t unpack_variant32(uint8_t *in, uint32_t length, variant32_t *value) {
-    uint32_t i = 0;
-    uint64_t v = 0; char b = 0; uint8_t by = 0;
-    do {
-        b = *in; ++in; ++i;
-        v |= (uint32_t)((uint8_t)b & 0x7f) << by;
-        by += 7;
-    } while( ((uint8_t)b) & 0x80 && by < 32 );
-    
-    *value = v;
-    return i;
-}
-
 uint32_t public_key_to_wif(uint8_t *publicKey, uint32_t keyLength, char *out, uint32_t outLength) {
     if (publicKey == NULL || keyLength < 33) {
         THROW(INVALID_PARAMETER);
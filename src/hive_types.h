@@ -37,8 +37,6 @@ typedef struct asset_t {
     symbol_t symbol;
 } asset_t;
 
-uint32_t unpack_variant32(uint8_t *in, uint32_t length, variant32_t *value);
-
 uint8_t asset_to_string(asset_t *asset, char *out, uint32_t size);
 
 uint32_t public_key_to_wif(uint8_t *publicKey, uint32_t keyLength, char *out, uint32_t outLength);
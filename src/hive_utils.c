@@ -186,157 +186,3 @@ bool tlvTryDecode(uint8_t *buffer, uint32_t bufferLength, uint32_t *fieldLenght,
 
     return true;
 }
-
-/**
- * Hive way to check if a signature is canonical :/
-*/
-unsigned char check_canonical(uint8_t *rs)
-{
-    return !(rs[0] & 0x80) 
-        && !(rs[0] == 0 
-        && !(rs[1] & 0x80)) 
-        && !(rs[32] & 0x80) 
-        && !(rs[32] == 0 && !(rs[33] & 0x80));
-}
-
-int ecdsa_der_to_sig(const uint8_t *der, uint8_t *sig)
-{
-    int length;
-    int offset = 2;
-    int delta = 0;
-    if (der[offset + 2] == 0)
-    {
-        length = der[offset + 1] - 1;
-        offset += 3;
-    }
-    else
-    {
-        length = der[offset + 1];
-        offset += 2;
-    }
-    if ((length < 0) || (length > 32))
-    {
-        return 0;
-    }
-    while ((length + delta) < 32)
-    {
-        sig[delta++] = 0;
-    }
-    os_memmove(sig + delta, der + offset, length);
-
-    delta = 0;
-    offset += length;
-    if (der[offset + 2] == 0)
-    {
-        length = der[offset + 1] - 1;
-        offset += 3;
-    }
-    else
-    {
-        length = der[offset + 1];
-        offset += 2;
-    }
-    if ((length < 0) || (length > 32))
-    {
-        return 0;
-    }
-    while ((length + delta) < 32)
-    {
-        sig[32 + delta++] = 0;
-    }
-    os_memmove(sig + 32 + delta, der + offset, length);
-
-    return 1;
-}
-
-/**
- * The nonce generated by internal library CX_RND_RFC6979 is not compatible
- * with Hive. So this is the way to generate nonce for Hive.
-*/
-void rng_rfc6979(unsigned char *rnd,
-                 unsigned char *h1,
-                 unsigned char *x, unsigned int x_len,
-                 const unsigned char *q, unsigned int q_len,
-                 unsigned char *V, unsigned char *K)
-{
-    unsigned int h_len, offset, found, i;
-    cx_hmac_sha256_t hmac;
-
-    h_len = 32;
-    //a. h1 as input
-
-    //loop for a candidate
-    found = 0;
-    while (!found)
-    {
-        if (x)
-        {
-            //b.  Set:          V = 0x01 0x01 0x01 ... 0x01
-            os_memset(V, 0x01, h_len);
-            //c. Set: K = 0x00 0x00 0x00 ... 0x00
-            os_memset(K, 0x00, h_len);
-            //d.  Set: K = HMAC_K(V || 0x00 || int2octets(x) || bits2octets(h1))
-            V[h_len] = 0;
-            cx_hmac_sha256_init(&hmac, K, 32);
-            cx_hmac(&hmac, 0, V, h_len + 1, K, 32);
-            cx_hmac(&hmac, 0, x, x_len, K, 32);
-            cx_hmac(&hmac, CX_LAST, h1, h_len, K, 32);
-            //e.  Set: V = HMAC_K(V)
-            cx_hmac_sha256_init(&hmac, K, 32);
-            cx_hmac((cx_hmac_t *)&hmac, CX_LAST, V, h_len, V, 32);
-            //f.  Set:  K = HMAC_K(V || 0x01 || int2octets(x) || bits2octets(h1))
-            V[h_len] = 1;
-            cx_hmac_sha256_init(&hmac, K, 32);
-            cx_hmac(&hmac, 0, V, h_len + 1, K, 32);
-            cx_hmac(&hmac, 0, x, x_len, K, 32);
-            cx_hmac(&hmac, CX_LAST, h1, h_len, K, 32);
-            //g. Set: V = HMAC_K(V) --
-            cx_hmac_sha256_init(&hmac, K, 32);
-            cx_hmac(&hmac, CX_LAST, V, h_len, V, 32);
-            // initial setup only once
-            x = NULL;
-        }
-        else
-        {
-            // h.3  K = HMAC_K(V || 0x00)
-            V[h_len] = 0;
-            cx_hmac_sha256_init(&hmac, K, 32);
-            cx_hmac(&hmac, CX_LAST, V, h_len + 1, K, 32);
-            // h.3 V = HMAC_K(V)
-            cx_hmac_sha256_init(&hmac, K, 32);
-            cx_hmac(&hmac, CX_LAST, V, h_len, V, 32);
-        }
-
-        //generate candidate
-        /* Shortcut: As only secp256k1/sha256 is supported, the step h.2 :
-         *   While tlen < qlen, do the following:
-         *     V = HMAC_K(V)
-         *     T = T || V
-         * is replace by 
-         *     V = HMAC_K(V)
-         */
-        x_len = q_len;
-        offset = 0;
-        while (x_len)
-        {
-            if (x_len < h_len)
-            {
-                h_len = x_len;
-            }
-            cx_hmac_sha256_init(&hmac, K, 32);
-            cx_hmac(&hmac, CX_LAST, V, h_len, V, 32);
-            os_memmove(rnd + offset, V, h_len);
-            x_len -= h_len;
-        }
-
-        // h.3 Check T is < n
-        for (i = 0; i < q_len; i++)
-        {
-            if (V[i] < q[i])
-            {
-                found = 1;
-                break;
-            }
-        }
-    }
-}
@@ -23,6 +23,13 @@
 #include "string.h"
 #include "hive_utils.h"
 #include "hive_stream.h"
+#include "hive_sign.h"
+#include "hive_review.h"
+#include "hive_session.h"
+#include "hive_keyindex.h"
+#include "hive_template.h"
+#include "hive_address_book.h"
+#include "hive_memo.h"
 
 #include "glyphs.h"
 
@@ -34,30 +41,78 @@ unsigned int io_seproxyhal_touch_tx_ok(const bagl_element_t *e);
 unsigned int io_seproxyhal_touch_tx_cancel(const bagl_element_t *e);
 unsigned int io_seproxyhal_touch_address_ok(const bagl_element_t *e);
 unsigned int io_seproxyhal_touch_address_cancel(const bagl_element_t *e);
+unsigned int io_seproxyhal_touch_session_ok(const bagl_element_t *e);
+unsigned int io_seproxyhal_touch_session_cancel(const bagl_element_t *e);
+unsigned int io_seproxyhal_touch_trust_ok(const bagl_element_t *e);
+unsigned int io_seproxyhal_touch_trust_cancel(const bagl_element_t *e);
+unsigned int io_seproxyhal_touch_memo_ok(const bagl_element_t *e);
+unsigned int io_seproxyhal_touch_memo_cancel(const bagl_element_t *e);
 void io_exchange_with_code(uint16_t code, uint32_t tx);
 void ui_idle(void);
 
 uint32_t get_public_key_and_set_result(void);
+void finalize_tx_hash(void);
 uint32_t sign_hash_and_set_result(void);
+bool prepare_signing_key_step(void);
+void clear_prepared_keys(void);
+void display_operation_review(void);
+void approve_operation(void);
+void resume_tx_stream(void);
+void refresh_operation_review(void);
+void refresh_session_status(void);
 
 #if defined(TARGET_NANOS)
 unsigned int ui_address_nanos_button(unsigned int button_mask, unsigned int button_mask_counter);
 unsigned int ui_single_action_tx_approval_nanos_button(unsigned int button_mask, unsigned int button_mask_counter);
 unsigned int ui_multiple_action_tx_approval_nanos_button(unsigned int button_mask, unsigned int button_mask_counter);
+unsigned int ui_hash_nanos_button(unsigned int button_mask, unsigned int button_mask_counter);
+unsigned int ui_session_nanos_button(unsigned int button_mask, unsigned int button_mask_counter);
+unsigned int ui_trust_nanos_button(unsigned int button_mask, unsigned int button_mask_counter);
+unsigned int ui_memo_nanos_button(unsigned int button_mask, unsigned int button_mask_counter);
 #endif // #if defined(TARGET_NANOS)
 
 #define MAX_BIP32_PATH 10
+#define MAX_SIGN_PATHS 3
 
 #define CLA 0xD4
 #define INS_GET_PUBLIC_KEY 0x02
 #define INS_SIGN 0x04
 #define INS_GET_APP_CONFIGURATION 0x06
+#define INS_FIND_PUBLIC_KEYS 0x08
+#define INS_SIGN_HASH 0x0A
+#define INS_SESSION 0x0C
+#define INS_TEMPLATE 0x0E
+#define INS_ADDRESS_BOOK 0x10
+#define INS_DECRYPT_MEMO 0x12
+#define INS_BENCHMARK 0xF0
 #define P1_CONFIRM 0x01
 #define P1_NON_CONFIRM 0x00
 #define P2_NO_CHAINCODE 0x00
 #define P2_CHAINCODE 0x01
+#define P2_EXTENDED_KEY 0x02
 #define P1_FIRST 0x00
 #define P1_MORE 0x80
+#define P2_SINGLE_PATH 0x00
+#define P2_MULTIPLE_PATHS 0x01
+#define P2_COMPRESSED 0x02
+#define P2_TEMPLATE 0x04
+#define P1_SESSION_START 0x00
+#define P1_SESSION_END 0x01
+#define P1_SESSION_STATUS 0x02
+#define P2_SESSION_POSTING 0x00
+#define P2_SESSION_WITNESS 0x01
+#define P1_TEMPLATE_REGISTER 0x00
+#define P1_TEMPLATE_CLEAR 0x01
+#define P1_ADDRESS_BOOK_ADD 0x00
+#define P1_ADDRESS_BOOK_REMOVE 0x01
+#define P1_ADDRESS_BOOK_LIST 0x02
+#define P1_ADDRESS_BOOK_CLEAR 0x03
+#define P1_MEMO_START 0x00
+#define P1_MEMO_END 0x01
+#define P1_MEMO_RECORDS 0x80
+
+#define MAX_FIND_TARGETS 4
+#define MAX_FIND_COUNT 20
 
 #define OFFSET_CLA 0
 #define OFFSET_INS 1
@@ -66,28 +121,27 @@ unsigned int ui_multiple_action_tx_approval_nanos_button(unsigned int button_mas
 #define OFFSET_LC 4
 #define OFFSET_CDATA 5
 
-uint8_t const SECP256K1_N[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
-                               0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe,
-                               0xba, 0xae, 0xdc, 0xe6, 0xaf, 0x48, 0xa0, 0x3b,
-                               0xbf, 0xd2, 0x5e, 0x8c, 0xd0, 0x36, 0x41, 0x41};
-
 typedef struct publicKeyContext_t
 {
     cx_ecfp_public_key_t publicKey;
     char address[60];
     uint8_t chainCode[32];
     bool getChaincode;
+    bool getExtendedKey;
+    uint8_t depth;
+    uint8_t parentFingerprint[4];
+    uint32_t childNumber;
 } publicKeyContext_t;
 
 typedef struct transactionContext_t
 {
-    uint8_t pathLength;
-    uint32_t bip32Path[MAX_BIP32_PATH];
+    uint8_t pathCount;
+    uint8_t pathLength[MAX_SIGN_PATHS];
+    uint32_t bip32Path[MAX_SIGN_PATHS][MAX_BIP32_PATH];
     uint8_t hash[32];
 } transactionContext_t;
 
 cx_sha256_t sha256;
-cx_sha256_t dataSha256;
 
 union {
     publicKeyContext_t publicKeyContext;
@@ -96,9 +150,59 @@ union {
 
 txProcessingContext_t txProcessingCtx;
 txProcessingContent_t txContent;
+reviewCache_t reviewCache;
+// a signing command is held until the user answers
+bool txReplyPending;
+// the displayed operation is still being received
+bool partialReview;
+// a memo batch, address book or session command is held until the user answers
+bool approvalPending;
+
+// private keys of the signing paths, derived while the user reviews
+#if defined(TARGET_NANOX)
+#define PREPARED_KEYS MAX_SIGN_PATHS
+#else
+#define PREPARED_KEYS 1
+#endif
+
+typedef struct preparedKeys_t
+{
+    // derived for the paths of the transaction being signed
+    bool requested;
+    uint8_t count;
+    cx_ecfp_private_key_t keys[PREPARED_KEYS];
+} preparedKeys_t;
+
+preparedKeys_t preparedKeys;
+
+hiveSession_t hiveSession;
+// the transaction being streamed uses the session path
+bool sessionPathTx;
+// and has only been made of operations the session signs without review
+bool sessionTx;
+// a transaction was rejected for mixing session and reviewed operations,
+// the next one is reviewed in full
+bool sessionReviewNext;
+volatile char sessionTitle[20];
+volatile char sessionAccounts[HIVE_SESSION_MAX_ACCOUNTS * (HIVE_ACCOUNT_NAME_LENGTH + 2)];
+volatile char sessionOperations[32];
+volatile char sessionStatus[32];
+
+// registered until the application exits
+hiveTemplate_t hiveTemplates[HIVE_TEMPLATES];
+
+// recipients waiting for the user to trust them
+addressBookBatch_t trustBatch;
+volatile char trustTitle[20];
+volatile char trustAccounts[ADDRESS_BOOK_BATCH * (ADDRESS_BOOK_NAME_LENGTH + 2)];
+
+// memo key approved to decrypt a batch of memos
+hiveMemoBatch_t memoBatch;
+volatile char memoPath[HIVE_MEMO_PATH_LENGTH * 12];
 
 volatile char actionCounter[32];
 volatile char confirmLabel[32];
+volatile char hashChunks[4][17];
 
 #ifdef TARGET_NANOX
 
@@ -117,6 +221,8 @@ unsigned int ux_step_count;
 
 typedef struct internalStorage_t {
     uint8_t dataAllowed;
+    uint8_t hashSignAllowed;
+    uint8_t compactReview;
     uint8_t initialized;
 } internalStorage_t;
 
@@ -135,6 +241,8 @@ const bagl_element_t *ui_menu_item_out_over(const bagl_element_t *e)
 const ux_menu_entry_t menu_main[];
 const ux_menu_entry_t menu_settings[];
 const ux_menu_entry_t menu_settings_data[];
+const ux_menu_entry_t menu_settings_hash[];
+const ux_menu_entry_t menu_settings_compact[];
 
 #ifdef HAVE_U2F
 
@@ -158,8 +266,50 @@ const ux_menu_entry_t menu_settings_data[] = {
     {NULL, menu_settings_data_change, 1, NULL, "Yes", NULL, 0, 0},
     UX_MENU_END};
 
+// change the setting
+void menu_settings_hash_change(unsigned int enabled)
+{
+    uint8_t hashSignAllowed = enabled;
+    nvm_write(&N_storage.hashSignAllowed, (void *)&hashSignAllowed, sizeof(uint8_t));
+    // go back to the menu entry
+    UX_MENU_DISPLAY(1, menu_settings, NULL);
+}
+
+// show the currently activated entry
+void menu_settings_hash_init(unsigned int ignored) {
+  UNUSED(ignored);
+  UX_MENU_DISPLAY(N_storage.hashSignAllowed?1:0, menu_settings_hash, NULL);
+}
+
+const ux_menu_entry_t menu_settings_hash[] = {
+    {NULL, menu_settings_hash_change, 0, NULL, "No", NULL, 0, 0},
+    {NULL, menu_settings_hash_change, 1, NULL, "Yes", NULL, 0, 0},
+    UX_MENU_END};
+
+// change the setting
+void menu_settings_compact_change(unsigned int enabled)
+{
+    uint8_t compactReview = enabled;
+    nvm_write(&N_storage.compactReview, (void *)&compactReview, sizeof(uint8_t));
+    // go back to the menu entry
+    UX_MENU_DISPLAY(2, menu_settings, NULL);
+}
+
+// show the currently activated entry
+void menu_settings_compact_init(unsigned int ignored) {
+  UNUSED(ignored);
+  UX_MENU_DISPLAY(N_storage.compactReview?1:0, menu_settings_compact, NULL);
+}
+
+const ux_menu_entry_t menu_settings_compact[] = {
+    {NULL, menu_settings_compact_change, 0, NULL, "No", NULL, 0, 0},
+    {NULL, menu_settings_compact_change, 1, NULL, "Yes", NULL, 0, 0},
+    UX_MENU_END};
+
 const ux_menu_entry_t menu_settings[] = {
     {NULL, menu_settings_data_init, 0, NULL, "Arbitrary data", NULL, 0, 0},
+    {NULL, menu_settings_hash_init, 0, NULL, "Hash signing", NULL, 0, 0},
+    {NULL, menu_settings_compact_init, 0, NULL, "Compact review", NULL, 0, 0},
     {menu_main, NULL, 1, &C_icon_back, "Back", NULL, 61, 40},
     UX_MENU_END};
 #endif // HAVE_U2F
@@ -169,6 +319,20 @@ const ux_menu_entry_t menu_about[] = {
     {menu_main, NULL, 2, &C_icon_back, "Back", NULL, 61, 40},
     UX_MENU_END};
 
+void menu_session_end(unsigned int ignored)
+{
+    UNUSED(ignored);
+    hive_session_revoke(&hiveSession);
+    ui_idle();
+}
+
+const ux_menu_entry_t menu_session[] = {
+    {NULL, NULL, 0, &C_nanos_badge_hive, (const char *)sessionTitle,
+     (const char *)sessionStatus, 33, 12},
+    {NULL, menu_session_end, 0, NULL, "End session", NULL, 0, 0},
+    {NULL, os_sched_exit, 0, &C_icon_dashboard, "Quit app", NULL, 50, 29},
+    UX_MENU_END};
+
 const ux_menu_entry_t menu_main[] = {
     {NULL, NULL, 0, &C_nanos_badge_hive, "Use wallet to",
      "view accounts", 33, 12},
@@ -274,7 +438,7 @@ unsigned int ui_address_prepro(const bagl_element_t *element)
     return 1;
 }
 
-const bagl_element_t ui_single_action_tx_approval_nanos[] = {
+const bagl_element_t ui_hash_nanos[] = {
     // type                               userid    x    y   w    h  str rad
     // fill      fg        bg      fid iid  txt   touchparams...       ]
     {{BAGL_RECTANGLE, 0x00, 0, 0, 128, 32, 0, 0, BAGL_FILL, 0x000000, 0xFFFFFF,
@@ -306,21 +470,18 @@ const bagl_element_t ui_single_action_tx_approval_nanos[] = {
      NULL,
      NULL},
 
-    //{{BAGL_ICON                           , 0x01,  21,   9,  14,  14, 0, 0, 0
-    //, 0xFFFFFF, 0x000000, 0, BAGL_GLYPH_ICON_TRANSACTION_BADGE  }, NULL, 0, 0,
-    //0, NULL, NULL, NULL },
-    {{BAGL_LABELINE, 0x01, 0, 12, 128, 32, 0, 0, 0, 0xFFFFFF, 0x000000,
+    {{BAGL_LABELINE, 0x01, 0, 12, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
       BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
-     "Confirm",
+     "Sign",
      0,
      0,
      0,
      NULL,
      NULL,
      NULL},
-    {{BAGL_LABELINE, 0x01, 0, 26, 128, 32, 0, 0, 0, 0xFFFFFF, 0x000000,
+    {{BAGL_LABELINE, 0x01, 0, 26, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
       BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
-     (char *)confirmLabel,
+     "Hash",
      0,
      0,
      0,
@@ -328,9 +489,151 @@ const bagl_element_t ui_single_action_tx_approval_nanos[] = {
      NULL,
      NULL},
 
-    {{BAGL_LABELINE, 0x02, 0, 12, 128, 32, 0, 0, 0, 0xFFFFFF, 0x000000,
+    {{BAGL_LABELINE, 0x02, 0, 12, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
       BAGL_FONT_OPEN_SANS_REGULAR_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
-     "OP Type",
+     "Hash 1/4",
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+    {{BAGL_LABELINE, 0x02, 0, 26, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     (char *)hashChunks[0],
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+
+    {{BAGL_LABELINE, 0x03, 0, 12, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_REGULAR_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     "Hash 2/4",
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+    {{BAGL_LABELINE, 0x03, 0, 26, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     (char *)hashChunks[1],
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+
+    {{BAGL_LABELINE, 0x04, 0, 12, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_REGULAR_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     "Hash 3/4",
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+    {{BAGL_LABELINE, 0x04, 0, 26, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     (char *)hashChunks[2],
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+
+    {{BAGL_LABELINE, 0x05, 0, 12, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_REGULAR_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     "Hash 4/4",
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+    {{BAGL_LABELINE, 0x05, 0, 26, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     (char *)hashChunks[3],
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+};
+
+unsigned int ui_hash_prepro(const bagl_element_t *element)
+{
+    if (element->component.userid > 0)
+    {
+        unsigned int display = (ux_step == element->component.userid - 1);
+        if (display)
+        {
+            UX_CALLBACK_SET_INTERVAL(2000);
+        }
+        return display;
+    }
+    return 1;
+}
+
+const bagl_element_t ui_session_nanos[] = {
+    // type                               userid    x    y   w    h  str rad
+    // fill      fg        bg      fid iid  txt   touchparams...       ]
+    {{BAGL_RECTANGLE, 0x00, 0, 0, 128, 32, 0, 0, BAGL_FILL, 0x000000, 0xFFFFFF,
+      0, 0},
+     NULL,
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+
+    {{BAGL_ICON, 0x00, 3, 12, 7, 7, 0, 0, 0, 0xFFFFFF, 0x000000, 0,
+      BAGL_GLYPH_ICON_CROSS},
+     NULL,
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+    {{BAGL_ICON, 0x00, 117, 13, 8, 6, 0, 0, 0, 0xFFFFFF, 0x000000, 0,
+      BAGL_GLYPH_ICON_CHECK},
+     NULL,
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+
+    {{BAGL_LABELINE, 0x01, 0, 12, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     "Start",
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+    {{BAGL_LABELINE, 0x01, 0, 26, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     (char *)sessionTitle,
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+
+    {{BAGL_LABELINE, 0x02, 0, 12, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_REGULAR_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     "Accounts",
      0,
      0,
      0,
@@ -339,7 +642,7 @@ const bagl_element_t ui_single_action_tx_approval_nanos[] = {
      NULL},
     {{BAGL_LABELINE, 0x02, 23, 26, 82, 12, 0x80 | 10, 0, 0, 0xFFFFFF, 0x000000,
       BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 26},
-     (char *)txContent.opName,
+     (char *)sessionAccounts,
      0,
      0,
      0,
@@ -347,9 +650,9 @@ const bagl_element_t ui_single_action_tx_approval_nanos[] = {
      NULL,
      NULL},
 
-    {{BAGL_LABELINE, 0x03, 0, 12, 128, 32, 0, 0, 0, 0xFFFFFF, 0x000000,
+    {{BAGL_LABELINE, 0x03, 0, 12, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
       BAGL_FONT_OPEN_SANS_REGULAR_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
-     (char *)txContent.arg.label,
+     "Operations",
      0,
      0,
      0,
@@ -358,7 +661,26 @@ const bagl_element_t ui_single_action_tx_approval_nanos[] = {
      NULL},
     {{BAGL_LABELINE, 0x03, 23, 26, 82, 12, 0x80 | 10, 0, 0, 0xFFFFFF, 0x000000,
       BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 26},
-     (char *)txContent.arg.data,
+     (char *)sessionOperations,
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+
+    {{BAGL_LABELINE, 0x04, 0, 12, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_REGULAR_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     "Limits",
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+    {{BAGL_LABELINE, 0x04, 0, 26, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     (char *)sessionStatus,
      0,
      0,
      0,
@@ -367,38 +689,31 @@ const bagl_element_t ui_single_action_tx_approval_nanos[] = {
      NULL},
 };
 
-unsigned int ui_single_action_tx_approval_prepro(const bagl_element_t *element)
+unsigned int ui_session_prepro(const bagl_element_t *element)
 {
-    unsigned int display = 1;
     if (element->component.userid > 0)
     {
-        if (ux_step > 2 && element->component.userid == 3) {
-            display = 1;
-        } else {
-            display = (ux_step == element->component.userid - 1);
-        }
+        unsigned int display = (ux_step == element->component.userid - 1);
         if (display)
         {
             switch (element->component.userid)
             {
             case 1:
-            case 2:
-                UX_CALLBACK_SET_INTERVAL(MAX(
-                    3000, 1000 + bagl_label_roundtrip_duration_ms(element, 7)));
+            case 4:
+                UX_CALLBACK_SET_INTERVAL(2000);
                 break;
-
-            case 3:
+            default:
                 UX_CALLBACK_SET_INTERVAL(MAX(
-                    3000, 1000 + bagl_label_roundtrip_duration_ms(element, 7)));                
-                printArgument(ux_step - 2, &txProcessingCtx);
+                    3000, 1000 + bagl_label_roundtrip_duration_ms(element, 7)));
                 break;
             }
         }
+        return display;
     }
-    return display;
+    return 1;
 }
 
-const bagl_element_t ui_multiple_action_tx_approval_nanos[] = {
+const bagl_element_t ui_trust_nanos[] = {
     // type                               userid    x    y   w    h  str rad
     // fill      fg        bg      fid iid  txt   touchparams...       ]
     {{BAGL_RECTANGLE, 0x00, 0, 0, 128, 32, 0, 0, BAGL_FILL, 0x000000, 0xFFFFFF,
@@ -430,21 +745,18 @@ const bagl_element_t ui_multiple_action_tx_approval_nanos[] = {
      NULL,
      NULL},
 
-    //{{BAGL_ICON                           , 0x01,  21,   9,  14,  14, 0, 0, 0
-    //, 0xFFFFFF, 0x000000, 0, BAGL_GLYPH_ICON_TRANSACTION_BADGE  }, NULL, 0, 0,
-    //0, NULL, NULL, NULL },
-    {{BAGL_LABELINE, 0x01, 0, 12, 128, 32, 0, 0, 0, 0xFFFFFF, 0x000000,
+    {{BAGL_LABELINE, 0x01, 0, 12, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
       BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
-     "Confirm",
+     "Trust",
      0,
      0,
      0,
      NULL,
      NULL,
      NULL},
-    {{BAGL_LABELINE, 0x01, 0, 26, 128, 32, 0, 0, 0, 0xFFFFFF, 0x000000,
+    {{BAGL_LABELINE, 0x01, 0, 26, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
       BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
-     "Transaction",
+     (char *)trustTitle,
      0,
      0,
      0,
@@ -452,9 +764,9 @@ const bagl_element_t ui_multiple_action_tx_approval_nanos[] = {
      NULL,
      NULL},
 
-    {{BAGL_LABELINE, 0x02, 0, 12, 128, 32, 0, 0, 0, 0xFFFFFF, 0x000000,
+    {{BAGL_LABELINE, 0x02, 0, 12, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
       BAGL_FONT_OPEN_SANS_REGULAR_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
-     "With",
+     "Accounts",
      0,
      0,
      0,
@@ -463,7 +775,7 @@ const bagl_element_t ui_multiple_action_tx_approval_nanos[] = {
      NULL},
     {{BAGL_LABELINE, 0x02, 23, 26, 82, 12, 0x80 | 10, 0, 0, 0xFFFFFF, 0x000000,
       BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 26},
-     (char *)actionCounter,
+     (char *)trustAccounts,
      0,
      0,
      0,
@@ -472,845 +784,2552 @@ const bagl_element_t ui_multiple_action_tx_approval_nanos[] = {
      NULL},
 };
 
-unsigned int ui_multiple_action_tx_approval_prepro(const bagl_element_t *element)
+unsigned int ui_trust_prepro(const bagl_element_t *element)
 {
-    unsigned int display = 1;
     if (element->component.userid > 0)
     {
-        display = (ux_step == element->component.userid - 1);
+        unsigned int display = (ux_step == element->component.userid - 1);
         if (display)
         {
             switch (element->component.userid)
             {
             case 1:
-            case 2:
                 UX_CALLBACK_SET_INTERVAL(2000);
                 break;
+            default:
+                UX_CALLBACK_SET_INTERVAL(MAX(
+                    3000, 1000 + bagl_label_roundtrip_duration_ms(element, 7)));
+                break;
             }
         }
+        return display;
     }
-    return display;
+    return 1;
 }
-#endif // #if defined(TARGET_NANOS)
 
-#if defined(TARGET_NANOX)
-
-void display_settings(void);
-void switch_settings_contract_data(void);
+const bagl_element_t ui_memo_nanos[] = {
+    // type                               userid    x    y   w    h  str rad
+    // fill      fg        bg      fid iid  txt   touchparams...       ]
+    {{BAGL_RECTANGLE, 0x00, 0, 0, 128, 32, 0, 0, BAGL_FILL, 0x000000, 0xFFFFFF,
+      0, 0},
+     NULL,
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
 
-UX_FLOW_DEF_NOCB(
-    ux_idle_flow_1_step,
-    bnn, //pnn,
-    {
-      "", //&C_icon_dashboard,
+    {{BAGL_ICON, 0x00, 3, 12, 7, 7, 0, 0, 0, 0xFFFFFF, 0x000000, 0,
+      BAGL_GLYPH_ICON_CROSS},
+     NULL,
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+    {{BAGL_ICON, 0x00, 117, 13, 8, 6, 0, 0, 0, 0xFFFFFF, 0x000000, 0,
+      BAGL_GLYPH_ICON_CHECK},
+     NULL,
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+
+    {{BAGL_LABELINE, 0x01, 0, 12, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     "Decrypt",
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+    {{BAGL_LABELINE, 0x01, 0, 26, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     "memos",
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+
+    {{BAGL_LABELINE, 0x02, 0, 12, 128, 12, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_REGULAR_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     "Memo key",
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+    {{BAGL_LABELINE, 0x02, 23, 26, 82, 12, 0x80 | 10, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 26},
+     (char *)memoPath,
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+};
+
+const bagl_element_t ui_single_action_tx_approval_nanos[] = {
+    // type                               userid    x    y   w    h  str rad
+    // fill      fg        bg      fid iid  txt   touchparams...       ]
+    {{BAGL_RECTANGLE, 0x00, 0, 0, 128, 32, 0, 0, BAGL_FILL, 0x000000, 0xFFFFFF,
+      0, 0},
+     NULL,
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+
+    {{BAGL_ICON, 0x00, 3, 12, 7, 7, 0, 0, 0, 0xFFFFFF, 0x000000, 0,
+      BAGL_GLYPH_ICON_CROSS},
+     NULL,
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+    {{BAGL_ICON, 0x00, 117, 13, 8, 6, 0, 0, 0, 0xFFFFFF, 0x000000, 0,
+      BAGL_GLYPH_ICON_CHECK},
+     NULL,
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+
+    //{{BAGL_ICON                           , 0x01,  21,   9,  14,  14, 0, 0, 0
+    //, 0xFFFFFF, 0x000000, 0, BAGL_GLYPH_ICON_TRANSACTION_BADGE  }, NULL, 0, 0,
+    //0, NULL, NULL, NULL },
+    {{BAGL_LABELINE, 0x01, 0, 12, 128, 32, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     "Confirm",
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+    {{BAGL_LABELINE, 0x01, 0, 26, 128, 32, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     (char *)confirmLabel,
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+
+    {{BAGL_LABELINE, 0x02, 0, 12, 128, 32, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_REGULAR_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     "OP Type",
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+    {{BAGL_LABELINE, 0x02, 23, 26, 82, 12, 0x80 | 10, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 26},
+     (char *)txContent.opName,
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+
+    {{BAGL_LABELINE, 0x03, 0, 12, 128, 32, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_REGULAR_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     (char *)txContent.arg.label,
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+    {{BAGL_LABELINE, 0x03, 23, 26, 82, 12, 0x80 | 10, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 26},
+     (char *)txContent.arg.data,
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+};
+
+unsigned int ui_single_action_tx_approval_prepro(const bagl_element_t *element)
+{
+    unsigned int display = 1;
+    if (element->component.userid > 0)
+    {
+        if (ux_step > 2 && element->component.userid == 3) {
+            display = 1;
+        } else {
+            display = (ux_step == element->component.userid - 1);
+        }
+        if (display)
+        {
+            switch (element->component.userid)
+            {
+            case 1:
+            case 2:
+                UX_CALLBACK_SET_INTERVAL(MAX(
+                    3000, 1000 + bagl_label_roundtrip_duration_ms(element, 7)));
+                break;
+
+            case 3:
+                UX_CALLBACK_SET_INTERVAL(MAX(
+                    3000, 1000 + bagl_label_roundtrip_duration_ms(element, 7)));                
+                showReviewPage(&reviewCache, &txProcessingCtx, ux_step - 2);
+                break;
+            }
+        }
+    }
+    return display;
+}
+
+const bagl_element_t ui_multiple_action_tx_approval_nanos[] = {
+    // type                               userid    x    y   w    h  str rad
+    // fill      fg        bg      fid iid  txt   touchparams...       ]
+    {{BAGL_RECTANGLE, 0x00, 0, 0, 128, 32, 0, 0, BAGL_FILL, 0x000000, 0xFFFFFF,
+      0, 0},
+     NULL,
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+
+    {{BAGL_ICON, 0x00, 3, 12, 7, 7, 0, 0, 0, 0xFFFFFF, 0x000000, 0,
+      BAGL_GLYPH_ICON_CROSS},
+     NULL,
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+    {{BAGL_ICON, 0x00, 117, 13, 8, 6, 0, 0, 0, 0xFFFFFF, 0x000000, 0,
+      BAGL_GLYPH_ICON_CHECK},
+     NULL,
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+
+    //{{BAGL_ICON                           , 0x01,  21,   9,  14,  14, 0, 0, 0
+    //, 0xFFFFFF, 0x000000, 0, BAGL_GLYPH_ICON_TRANSACTION_BADGE  }, NULL, 0, 0,
+    //0, NULL, NULL, NULL },
+    {{BAGL_LABELINE, 0x01, 0, 12, 128, 32, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     "Confirm",
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+    {{BAGL_LABELINE, 0x01, 0, 26, 128, 32, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     "Transaction",
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+
+    {{BAGL_LABELINE, 0x02, 0, 12, 128, 32, 0, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_REGULAR_11px | BAGL_FONT_ALIGNMENT_CENTER, 0},
+     "With",
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+    {{BAGL_LABELINE, 0x02, 23, 26, 82, 12, 0x80 | 10, 0, 0, 0xFFFFFF, 0x000000,
+      BAGL_FONT_OPEN_SANS_EXTRABOLD_11px | BAGL_FONT_ALIGNMENT_CENTER, 26},
+     (char *)actionCounter,
+     0,
+     0,
+     0,
+     NULL,
+     NULL,
+     NULL},
+};
+
+unsigned int ui_multiple_action_tx_approval_prepro(const bagl_element_t *element)
+{
+    unsigned int display = 1;
+    if (element->component.userid > 0)
+    {
+        display = (ux_step == element->component.userid - 1);
+        if (display)
+        {
+            switch (element->component.userid)
+            {
+            case 1:
+            case 2:
+                UX_CALLBACK_SET_INTERVAL(2000);
+                break;
+            }
+        }
+    }
+    return display;
+}
+#endif // #if defined(TARGET_NANOS)
+
+#if defined(TARGET_NANOX)
+
+void display_settings(void);
+void switch_settings_contract_data(void);
+void switch_settings_hash_signing(void);
+void switch_settings_compact_review(void);
+
+volatile char hashSignLabel[16];
+volatile char compactReviewLabel[16];
+
+UX_FLOW_DEF_NOCB(
+    ux_idle_flow_1_step,
+    bnn, //pnn,
+    {
+      "", //&C_icon_dashboard,
       "Application",
       "is ready",
     });
 UX_FLOW_DEF_NOCB(
-    ux_idle_flow_2_step,
-    bn,
+    ux_idle_flow_2_step,
+    bn,
+    {
+      "Version",
+      APPVERSION,
+    });
+UX_FLOW_DEF_VALID(
+    ux_idle_flow_3_step,
+    pb,
+    display_settings(),
+    {
+      &C_icon_coggle,
+      "Settings",
+    });
+UX_FLOW_DEF_VALID(
+    ux_idle_flow_4_step,
+    pb,
+    os_sched_exit(-1),
+    {
+      &C_icon_dashboard_x,
+      "Quit",
+    });
+
+UX_FLOW(
+    ux_idle_flow,
+    &ux_idle_flow_1_step,
+    &ux_idle_flow_2_step,
+    &ux_idle_flow_3_step,
+    &ux_idle_flow_4_step
+);
+
+UX_FLOW_DEF_VALID(
+    ux_settings_flow_1_step,
+    bnnn,
+    switch_settings_contract_data(),
+    {
+      "Contract data",
+      "Allow contract data",
+      "in transactions",
+      confirmLabel,
+    });
+
+UX_FLOW_DEF_VALID(
+    ux_settings_flow_2_step,
+    bnnn,
+    switch_settings_hash_signing(),
+    {
+      "Hash signing",
+      "Allow signing of",
+      "raw hashes",
+      hashSignLabel,
+    });
+
+UX_FLOW_DEF_VALID(
+    ux_settings_flow_3_step,
+    bnnn,
+    switch_settings_compact_review(),
+    {
+      "Compact review",
+      "Hide default values",
+      "and pack short fields",
+      compactReviewLabel,
+    });
+
+UX_FLOW_DEF_VALID(
+    ux_settings_flow_4_step,
+    pb,
+    ui_idle(),
+    {
+      &C_icon_back_x,
+      "Back",
+    });
+
+UX_FLOW(
+    ux_settings_flow, 
+    &ux_settings_flow_1_step,
+    &ux_settings_flow_2_step,
+    &ux_settings_flow_3_step,
+    &ux_settings_flow_4_step
+);
+
+void display_settings_at(uint32_t step) {
+  strcpy(confirmLabel, (N_storage.dataAllowed ? "Allowed" : "NOT Allowed"));
+  strcpy(hashSignLabel, (N_storage.hashSignAllowed ? "Allowed" : "NOT Allowed"));
+  strcpy(compactReviewLabel, (N_storage.compactReview ? "Enabled" : "Disabled"));
+  ux_flow_init(0, ux_settings_flow, ux_settings_flow[step]);
+}
+
+void display_settings() {
+  display_settings_at(0);
+}
+
+void switch_settings_contract_data() {
+  uint8_t value = (N_storage.dataAllowed ? 0 : 1);
+  nvm_write(&N_storage.dataAllowed, (void*)&value, sizeof(uint8_t));
+  display_settings();
+}
+
+void switch_settings_hash_signing() {
+  uint8_t value = (N_storage.hashSignAllowed ? 0 : 1);
+  nvm_write(&N_storage.hashSignAllowed, (void*)&value, sizeof(uint8_t));
+  display_settings_at(1);
+}
+
+void switch_settings_compact_review() {
+  uint8_t value = (N_storage.compactReview ? 0 : 1);
+  nvm_write(&N_storage.compactReview, (void*)&value, sizeof(uint8_t));
+  display_settings_at(2);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+UX_FLOW_DEF_NOCB(
+    ux_display_public_flow_1_step,
+    pnn,
+    {
+      &C_icon_eye,
+      "Verify",
+      "Public Key",
+    });
+UX_FLOW_DEF_NOCB(
+    ux_display_public_flow_2_step,
+    bnnn_paging,
+    {
+      .title = "Public Key",
+      .text = tmpCtx.publicKeyContext.address,
+    });
+UX_FLOW_DEF_VALID(
+    ux_display_public_flow_3_step,
+    pb,
+    io_seproxyhal_touch_address_ok(NULL),
+    {
+      &C_icon_validate_14,
+      "Approve",
+    });
+UX_FLOW_DEF_VALID(
+    ux_display_public_flow_4_step,
+    pb,
+    io_seproxyhal_touch_address_cancel(NULL),
+    {
+      &C_icon_crossmark,
+      "Reject",
+    });
+
+UX_FLOW(
+    ux_display_public_flow,
+    &ux_display_public_flow_1_step,
+    &ux_display_public_flow_2_step,
+    &ux_display_public_flow_3_step,
+    &ux_display_public_flow_4_step
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+UX_FLOW_DEF_NOCB(
+    ux_sign_hash_flow_1_step,
+    pnn,
+    {
+      &C_icon_warning,
+      "Sign",
+      "Hash",
+    });
+UX_FLOW_DEF_NOCB(
+    ux_sign_hash_flow_2_step,
+    bn,
+    {
+      "Hash 1/4",
+      hashChunks[0],
+    });
+UX_FLOW_DEF_NOCB(
+    ux_sign_hash_flow_3_step,
+    bn,
+    {
+      "Hash 2/4",
+      hashChunks[1],
+    });
+UX_FLOW_DEF_NOCB(
+    ux_sign_hash_flow_4_step,
+    bn,
+    {
+      "Hash 3/4",
+      hashChunks[2],
+    });
+UX_FLOW_DEF_NOCB(
+    ux_sign_hash_flow_5_step,
+    bn,
+    {
+      "Hash 4/4",
+      hashChunks[3],
+    });
+UX_FLOW_DEF_VALID(
+    ux_sign_hash_flow_6_step,
+    pbb,
+    io_seproxyhal_touch_tx_ok(NULL),
+    {
+      &C_icon_validate_14,
+      "Sign",
+      "hash",
+    });
+UX_FLOW_DEF_VALID(
+    ux_sign_hash_flow_7_step,
+    pbb,
+    io_seproxyhal_touch_tx_cancel(NULL),
+    {
+      &C_icon_crossmark,
+      "Cancel",
+      "signature",
+    });
+
+UX_FLOW(
+    ux_sign_hash_flow,
+    &ux_sign_hash_flow_1_step,
+    &ux_sign_hash_flow_2_step,
+    &ux_sign_hash_flow_3_step,
+    &ux_sign_hash_flow_4_step,
+    &ux_sign_hash_flow_5_step,
+    &ux_sign_hash_flow_6_step,
+    &ux_sign_hash_flow_7_step
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+UX_FLOW_DEF_NOCB(
+    ux_start_session_flow_1_step,
+    pnn,
+    {
+      &C_icon_warning,
+      "Start",
+      sessionTitle,
+    });
+UX_STEP_NOCB(
+    ux_start_session_flow_2_step,
+    bnnn_paging,
+    {
+      .title = "Accounts",
+      .text = sessionAccounts,
+    });
+UX_FLOW_DEF_NOCB(
+    ux_start_session_flow_3_step,
+    bn,
+    {
+      "Operations",
+      sessionOperations,
+    });
+UX_FLOW_DEF_NOCB(
+    ux_start_session_flow_4_step,
+    bn,
+    {
+      "Limits",
+      sessionStatus,
+    });
+UX_FLOW_DEF_VALID(
+    ux_start_session_flow_5_step,
+    pb,
+    io_seproxyhal_touch_session_ok(NULL),
+    {
+      &C_icon_validate_14,
+      "Approve",
+    });
+UX_FLOW_DEF_VALID(
+    ux_start_session_flow_6_step,
+    pb,
+    io_seproxyhal_touch_session_cancel(NULL),
+    {
+      &C_icon_crossmark,
+      "Reject",
+    });
+
+UX_FLOW(
+    ux_start_session_flow,
+    &ux_start_session_flow_1_step,
+    &ux_start_session_flow_2_step,
+    &ux_start_session_flow_3_step,
+    &ux_start_session_flow_4_step,
+    &ux_start_session_flow_5_step,
+    &ux_start_session_flow_6_step
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+UX_FLOW_DEF_NOCB(
+    ux_trust_flow_1_step,
+    pnn,
     {
-      "Version",
-      APPVERSION,
+      &C_icon_eye,
+      "Trust",
+      trustTitle,
+    });
+UX_STEP_NOCB(
+    ux_trust_flow_2_step,
+    bnnn_paging,
+    {
+      .title = "Accounts",
+      .text = trustAccounts,
     });
 UX_FLOW_DEF_VALID(
-    ux_idle_flow_3_step,
+    ux_trust_flow_3_step,
     pb,
-    display_settings(),
+    io_seproxyhal_touch_trust_ok(NULL),
     {
-      &C_icon_coggle,
-      "Settings",
+      &C_icon_validate_14,
+      "Approve",
+    });
+UX_FLOW_DEF_VALID(
+    ux_trust_flow_4_step,
+    pb,
+    io_seproxyhal_touch_trust_cancel(NULL),
+    {
+      &C_icon_crossmark,
+      "Reject",
+    });
+
+UX_FLOW(
+    ux_trust_flow,
+    &ux_trust_flow_1_step,
+    &ux_trust_flow_2_step,
+    &ux_trust_flow_3_step,
+    &ux_trust_flow_4_step
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+UX_FLOW_DEF_NOCB(
+    ux_memo_flow_1_step,
+    pnn,
+    {
+      &C_icon_eye,
+      "Decrypt",
+      "memos",
+    });
+UX_STEP_NOCB(
+    ux_memo_flow_2_step,
+    bnnn_paging,
+    {
+      .title = "Memo key",
+      .text = memoPath,
+    });
+UX_FLOW_DEF_VALID(
+    ux_memo_flow_3_step,
+    pb,
+    io_seproxyhal_touch_memo_ok(NULL),
+    {
+      &C_icon_validate_14,
+      "Approve",
+    });
+UX_FLOW_DEF_VALID(
+    ux_memo_flow_4_step,
+    pb,
+    io_seproxyhal_touch_memo_cancel(NULL),
+    {
+      &C_icon_crossmark,
+      "Reject",
+    });
+
+UX_FLOW(
+    ux_memo_flow,
+    &ux_memo_flow_1_step,
+    &ux_memo_flow_2_step,
+    &ux_memo_flow_3_step,
+    &ux_memo_flow_4_step
+);
+
+void end_session(void)
+{
+    hive_session_revoke(&hiveSession);
+    ui_idle();
+}
+
+UX_FLOW_DEF_NOCB(
+    ux_session_flow_1_step,
+    pnn,
+    {
+      &C_icon_certificate,
+      sessionTitle,
+      sessionStatus,
+    });
+UX_STEP_NOCB(
+    ux_session_flow_2_step,
+    bnnn_paging,
+    {
+      .title = "Accounts",
+      .text = sessionAccounts,
+    });
+UX_FLOW_DEF_VALID(
+    ux_session_flow_3_step,
+    pb,
+    end_session(),
+    {
+      &C_icon_crossmark,
+      "End session",
+    });
+UX_FLOW_DEF_VALID(
+    ux_session_flow_4_step,
+    pb,
+    os_sched_exit(-1),
+    {
+      &C_icon_dashboard_x,
+      "Quit",
+    });
+
+UX_FLOW(
+    ux_session_flow,
+    &ux_session_flow_1_step,
+    &ux_session_flow_2_step,
+    &ux_session_flow_3_step,
+    &ux_session_flow_4_step
+);
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define STATE_LEFT_BORDER 0
+#define STATE_VARIABLE 1
+#define STATE_RIGHT_BORDER 2
+
+volatile char confirm_text1[16];
+volatile char confirm_text2[16];
+
+void display_next_state(uint8_t state);
+void ux_single_action_sign_flow_ok_pressed();
+
+UX_FLOW_DEF_NOCB(
+    ux_single_action_sign_flow_1_step,
+    pnn,
+    {
+      &C_icon_certificate,
+      "Review",
+      confirmLabel,
+    });
+UX_FLOW_DEF_NOCB(
+    ux_single_action_sign_flow_2_step,
+    bn,
+    {
+      "OP Type",
+      txContent.opName,
+    });
+UX_STEP_INIT(
+    ux_init_left_border,
+    NULL,
+    NULL,
+    {
+        display_next_state(STATE_LEFT_BORDER);
+    });
+
+UX_STEP_NOCB_INIT(
+    ux_single_action_sign_flow_variable_step,
+    bnnn_paging,
+    {
+        display_next_state(STATE_VARIABLE);
+    },
+    {
+      .title = txContent.arg.label,
+      .text = txContent.arg.data,
+    });
+
+UX_STEP_INIT(
+    ux_init_right_border,
+    NULL,
+    NULL,
+    {
+        display_next_state(STATE_RIGHT_BORDER);
+    });
+
+UX_FLOW_DEF_VALID(
+    ux_single_action_sign_flow_6_step,
+    pbb,
+    ux_single_action_sign_flow_ok_pressed(),
+    {
+      &C_icon_validate_14,
+      confirm_text1,
+      confirm_text2,
+    });
+UX_FLOW_DEF_VALID(
+    ux_single_action_sign_flow_7_step,
+    pbb,
+    io_seproxyhal_touch_tx_cancel(NULL),
+    {
+      &C_icon_crossmark,
+      "Cancel",
+      "signature",
+    });
+
+UX_FLOW(
+    ux_single_action_sign_flow, 
+    &ux_single_action_sign_flow_1_step,
+    &ux_single_action_sign_flow_2_step,
+    &ux_init_left_border,
+    &ux_single_action_sign_flow_variable_step,
+    &ux_init_right_border,
+    &ux_single_action_sign_flow_6_step,
+    &ux_single_action_sign_flow_7_step
+);
+
+void display_next_state(uint8_t state) 
+{    
+    if (state == STATE_LEFT_BORDER)
+    {
+        if (ux_step == 0)
+        {
+            ux_step = 1;
+            ux_flow_next();
+        }
+        else if (ux_step == 1) 
+        {
+            --ux_step;
+            ux_flow_prev();
+        }
+        else if (ux_step > 1)
+        {
+            --ux_step;
+            ux_flow_next();
+        }
+    }
+    else if (state == STATE_VARIABLE)
+    {
+        showReviewPage(&reviewCache, &txProcessingCtx, ux_step - 1);
+    }
+    else if (state == STATE_RIGHT_BORDER)
+    {
+        if (ux_step < ux_step_count)
+        {
+            ++ux_step;
+            ux_flow_prev();
+        }
+        else if (ux_step == ux_step_count)
+        {
+            ++ux_step;
+            ux_flow_next();
+        }
+        else if (ux_step > ux_step_count)
+        {
+            ux_step = ux_step_count;
+            ux_flow_prev();
+        }
+    }
+}
+
+void ux_single_action_sign_flow_ok_pressed() 
+{
+    // enabled once the whole operation has been hashed
+    if (!partialReview)
+    {
+        approve_operation();
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+
+void ux_multiple_action_sign_flow_ok_pressed();
+
+UX_FLOW_DEF_NOCB(
+    ux_multiple_action_sign_flow_1_step,
+    pnn,
+    {
+      &C_icon_certificate,
+      "Review",
+      "Transaction",
+    });
+UX_FLOW_DEF_NOCB(
+    ux_multiple_action_sign_flow_2_step,
+    bn, //pnn,
+    {
+      "With",
+      actionCounter,
+    });
+UX_FLOW_DEF_VALID(
+    ux_multiple_action_sign_flow_3_step,
+    pbb,
+    ux_multiple_action_sign_flow_ok_pressed(),
+    {
+      &C_icon_validate_14,
+      "Continue",
+      "review"
     });
 UX_FLOW_DEF_VALID(
-    ux_idle_flow_4_step,
-    pb,
-    os_sched_exit(-1),
+    ux_multiple_action_sign_flow_4_step,
+    pbb,
+    io_seproxyhal_touch_tx_cancel(NULL),
+    {
+      &C_icon_crossmark,
+      "Cancel",
+      "review",
+    });
+
+UX_FLOW(
+    ux_multiple_action_sign_flow, 
+    &ux_multiple_action_sign_flow_1_step,
+    &ux_multiple_action_sign_flow_2_step,
+    &ux_multiple_action_sign_flow_3_step,
+    &ux_multiple_action_sign_flow_4_step
+);
+
+void ux_multiple_action_sign_flow_ok_pressed()
+{
+    resume_tx_stream();
+    if (pendingOperations(&txProcessingCtx) == 0 && !partialReview) {
+        ui_idle();
+    }
+}
+
+#endif // #if defined(TARGET_NANOX)
+
+void ui_idle(void)
+{
+    initReviewCache(&reviewCache);
+    partialReview = false;
+#if defined(TARGET_NANOS)
+    if (hiveSession.active)
+    {
+        refresh_session_status();
+        UX_MENU_DISPLAY(0, menu_session, NULL);
+        return;
+    }
+    UX_MENU_DISPLAY(0, menu_main, NULL);
+#elif defined(TARGET_NANOX)
+    // reserve a display stack slot if none yet
+    if(G_ux.stack_count == 0) {
+        ux_stack_push();
+    }
+    if (hiveSession.active)
+    {
+        refresh_session_status();
+        ux_flow_init(0, ux_session_flow, NULL);
+        return;
+    }
+    ux_flow_init(0, ux_idle_flow, NULL);
+#endif
+}
+
+unsigned int io_seproxyhal_touch_exit(const bagl_element_t *e)
+{
+    // Go back to the dashboard
+    os_sched_exit(0);
+    return 0; // do not redraw the widget
+}
+
+unsigned int io_seproxyhal_touch_address_ok(const bagl_element_t *e)
+{
+    uint32_t tx = get_public_key_and_set_result();
+    io_exchange_with_code(0x9000, tx);
+    // Display back the original UX
+    ui_idle();
+    return 0; // do not redraw the widget
+}
+
+unsigned int io_seproxyhal_touch_address_cancel(const bagl_element_t *e)
+{
+    io_exchange_with_code(0x6985, 0);
+    // Display back the original UX
+    ui_idle();
+    return 0; // do not redraw the widget
+}
+
+unsigned int io_seproxyhal_touch_session_ok(const bagl_element_t *e)
+{
+    approvalPending = false;
+    hive_session_activate(&hiveSession);
+    io_exchange_with_code(0x9000, 0);
+    // Display the session status
+    ui_idle();
+    return 0; // do not redraw the widget
+}
+
+unsigned int io_seproxyhal_touch_session_cancel(const bagl_element_t *e)
+{
+    approvalPending = false;
+    hive_session_revoke(&hiveSession);
+    io_exchange_with_code(0x6985, 0);
+    // Display back the original UX
+    ui_idle();
+    return 0; // do not redraw the widget
+}
+
+unsigned int io_seproxyhal_touch_trust_ok(const bagl_element_t *e)
+{
+    approvalPending = false;
+    // checked again against the table as it is written
+    io_exchange_with_code(hive_address_book_add(&trustBatch) ? 0x9000 : 0x6A84, 0);
+    os_memset(&trustBatch, 0, sizeof(trustBatch));
+    // Display back the original UX
+    ui_idle();
+    return 0; // do not redraw the widget
+}
+
+unsigned int io_seproxyhal_touch_trust_cancel(const bagl_element_t *e)
+{
+    approvalPending = false;
+    os_memset(&trustBatch, 0, sizeof(trustBatch));
+    io_exchange_with_code(0x6985, 0);
+    // Display back the original UX
+    ui_idle();
+    return 0; // do not redraw the widget
+}
+
+unsigned int io_seproxyhal_touch_memo_ok(const bagl_element_t *e)
+{
+    approvalPending = false;
+    io_exchange_with_code(hive_memo_begin(&memoBatch) ? 0x9000 : 0x6a80, 0);
+    // Display back the original UX
+    ui_idle();
+    return 0; // do not redraw the widget
+}
+
+unsigned int io_seproxyhal_touch_memo_cancel(const bagl_element_t *e)
+{
+    approvalPending = false;
+    hive_memo_end(&memoBatch);
+    io_exchange_with_code(0x6985, 0);
+    // Display back the original UX
+    ui_idle();
+    return 0; // do not redraw the widget
+}
+
+/**
+ * Update the remaining session limits shown on screen.
+*/
+void refresh_session_status(void)
+{
+    if (hiveSession.active)
+    {
+        snprintf((char *)sessionStatus, sizeof(sessionStatus), "%d sigs, %d min left",
+                 hiveSession.signaturesLeft, hive_session_minutes_left(&hiveSession));
+    }
+    else
+    {
+        strcpy((char *)sessionStatus, "Ended");
+    }
+}
+
+#if defined(TARGET_NANOS)
+unsigned int ui_address_nanos_button(unsigned int button_mask,
+                                     unsigned int button_mask_counter)
+{
+    switch (button_mask)
+    {
+    case BUTTON_EVT_RELEASED | BUTTON_LEFT: // CANCEL
+        io_seproxyhal_touch_address_cancel(NULL);
+        break;
+
+    case BUTTON_EVT_RELEASED | BUTTON_RIGHT:
+    { // OK
+        io_seproxyhal_touch_address_ok(NULL);
+        break;
+    }
+    }
+    return 0;
+}
+#endif // ui_address_nanos_button
+
+void finalize_tx_hash(void)
+{
+    cx_hash(&sha256.header, CX_LAST, tmpCtx.transactionContext.hash, 0, 
+        tmpCtx.transactionContext.hash, sizeof(tmpCtx.transactionContext.hash));
+}
+
+#if defined(TARGET_NANOX)
+static void set_confirm_text(operationSlot_t *operation)
+{
+    if (partialReview)
+    {
+        strcpy((char *)confirm_text1, "Receiving");
+        strcpy((char *)confirm_text2, "operation...");
+    }
+    else
+    {
+        strcpy((char *)confirm_text1, operation->opIndex == txProcessingCtx.numOperations ? "Sign" : "Accept");
+        strcpy((char *)confirm_text2, operation->opIndex == txProcessingCtx.numOperations ? "transaction" : "and review next");
+    }
+}
+#endif
+
+/**
+ * Show the oldest staged operation for review, possibly while it is
+ * still being received.
+*/
+void display_operation_review(void)
+{
+    operationSlot_t *operation = reviewedOperation(&txProcessingCtx);
+
+    txContent.opType = operation->opType;
+    txContent.argumentCount = operation->argumentCount;
+    os_memmove(txContent.opName, operation->opName, sizeof(txContent.opName));
+
+    if (txProcessingCtx.numOperations > 1) {
+        snprintf((char *)confirmLabel, sizeof(confirmLabel), "Action #%d", operation->opIndex);
+    } else {
+        strcpy((char *)confirmLabel, "Transaction");
+    }
+
+    partialReview = partialOperation(&txProcessingCtx);
+    ux_step = 0;
+    ux_step_count = mapReviewPages(&reviewCache, &txProcessingCtx, N_storage.compactReview);
+#if defined(TARGET_NANOS)
+    ux_step_count += 2;
+    UX_DISPLAY(ui_single_action_tx_approval_nanos, ui_single_action_tx_approval_prepro);
+#elif defined(TARGET_NANOX)
+    set_confirm_text(operation);
+    ux_flow_init(0, ux_single_action_sign_flow, NULL);
+#endif
+}
+
+/**
+ * More of the displayed operation has been received, or all of it: lay
+ * out its pages again and decode the current one, which was waiting for
+ * its fields. Approving is possible once the operation is complete.
+*/
+void refresh_operation_review(void)
+{
+    bool pastPages = ux_step > ux_step_count;
+
+    partialReview = partialOperation(&txProcessingCtx);
+    ux_step_count = remapReviewPages(&reviewCache, &txProcessingCtx, N_storage.compactReview);
+#if defined(TARGET_NANOS)
+    UNUSED(pastPages);
+    ux_step_count += 2;
+    if (ux_step >= 2)
+    {
+        ux_step = reviewCache.current + 2;
+        UX_REDISPLAY();
+    }
+#elif defined(TARGET_NANOX)
+    set_confirm_text(reviewedOperation(&txProcessingCtx));
+    if (pastPages)
+    {
+        // the approval steps show the new text when displayed again
+        ux_step = ux_step_count + 1;
+    }
+    else if (ux_step > 0 && reviewCache.currentPending)
+    {
+        ux_step = reviewCache.current + 1;
+        ux_flow_init(0, ux_single_action_sign_flow, &ux_single_action_sign_flow_variable_step);
+    }
+#endif
+}
+
+/**
+ * Feed the held command to the parser. A command is answered as soon as
+ * all its operations are staged, so the host streams the next ones while
+ * the user is still reviewing. It is held only when every operation slot
+ * is taken, or when the transaction is complete but not yet accepted.
+ * Returns the status word to answer with, or 0 to keep the command held.
+*/
+static uint16_t stream_tx(uint8_t *buffer, uint32_t length, uint32_t *tx)
+{
+    *tx = 0;
+    for (;;)
+    {
+        parserStatus_e txResult = parseTx(&txProcessingCtx, buffer, length);
+        // the rest of the command stays loaded in the parser
+        buffer = NULL;
+        length = 0;
+
+        switch (txResult)
+        {
+        case STREAM_CONFIRM_PROCESSING:
+            snprintf((char *)actionCounter, sizeof(actionCounter), "%d operations", txProcessingCtx.numOperations);
+#if defined(TARGET_NANOS)
+            ux_step = 0;
+            ux_step_count = 2;
+            UX_DISPLAY(ui_multiple_action_tx_approval_nanos, ui_multiple_action_tx_approval_prepro);
+#elif defined(TARGET_NANOX)
+            ux_flow_init(0, ux_multiple_action_sign_flow, NULL);
+#endif
+            return 0;
+        case STREAM_ACTION_READY:
+            if (sessionTx)
+            {
+                operationSlot_t *operation = reviewedOperation(&txProcessingCtx);
+                if (hive_session_allows(&hiveSession, operation->opType,
+                                        operation->data, operation->dataLength))
+                {
+                    releaseOperation(&txProcessingCtx);
+                    break;
+                }
+                // anything outside of the session is reviewed, and ends a posting session
+                if (hiveSession.kind == HIVE_SESSION_POSTING)
+                {
+                    hive_session_revoke(&hiveSession);
+                    refresh_session_status();
+                }
+                sessionTx = false;
+                if (operation->opIndex > 1)
+                {
+                    // the operations released before were never displayed,
+                    // the host submits the transaction again for a full review
+                    sessionReviewNext = true;
+                    abortTx(&txProcessingCtx);
+                    clear_prepared_keys();
+                    ui_idle();
+                    return 0x6985;
+                }
+            }
+            if (partialReview)
+            {
+                // the displayed operation is complete
+                refresh_operation_review();
+            }
+            else if (pendingOperations(&txProcessingCtx) == 1)
+            {
+                display_operation_review();
+            }
+            break;
+        case STREAM_ACTION_UPDATED:
+            // session operations are only reviewed when complete
+            if (sessionTx)
+            {
+                break;
+            }
+            if (partialReview)
+            {
+                if (reviewCache.currentPending)
+                {
+                    refresh_operation_review();
+                }
+            }
+            else if (pendingOperations(&txProcessingCtx) == 0 && partialOperation(&txProcessingCtx))
+            {
+                display_operation_review();
+            }
+            break;
+        case STREAM_QUEUE_FULL:
+            return 0;
+        case STREAM_PROCESSING:
+            return 0x9000;
+        case STREAM_FINISHED:
+            if (pendingOperations(&txProcessingCtx) != 0)
+            {
+                return 0;
+            }
+            finalize_tx_hash();
+            if (sessionTx)
+            {
+                sessionTx = false;
+                if (!hiveSession.active)
+                {
+                    // expired while streaming
+                    abortTx(&txProcessingCtx);
+                    clear_prepared_keys();
+                    return 0x6985;
+                }
+                *tx = hive_session_sign(&hiveSession, tmpCtx.transactionContext.hash, G_io_apdu_buffer);
+                clear_prepared_keys();
+                refresh_session_status();
+                UX_REDISPLAY();
+            }
+            else
+            {
+                *tx = sign_hash_and_set_result();
+                if (sessionPathTx)
+                {
+                    hive_session_commit(&hiveSession);
+                }
+            }
+            abortTx(&txProcessingCtx);
+            return 0x9000;
+        default:
+            PRINTF("Unexpected parser status\n");
+            abortTx(&txProcessingCtx);
+            clear_prepared_keys();
+            if (partialReview)
+            {
+                // the operation on screen did not validate once received
+                ui_idle();
+            }
+            return 0x6A80;
+        }
+    }
+}
+
+/**
+ * Continue a held command once the user let the stream go on.
+*/
+void resume_tx_stream(void)
+{
+    uint32_t tx = 0;
+    uint16_t sw;
+
+    if (!txReplyPending)
+    {
+        return;
+    }
+    sw = stream_tx(NULL, 0, &tx);
+    if (sw != 0)
+    {
+        txReplyPending = false;
+        io_exchange_with_code(sw, tx);
+    }
+}
+
+/**
+ * The reviewed operation is accepted: move on to the next staged one
+ * straight away and let the parser fill the freed slot.
+*/
+void approve_operation(void)
+{
+    if (sessionPathTx)
+    {
+        operationSlot_t *operation = reviewedOperation(&txProcessingCtx);
+        hive_session_record(&hiveSession, operation->opType,
+                            operation->data, operation->dataLength);
+    }
+    releaseOperation(&txProcessingCtx);
+    if (pendingOperations(&txProcessingCtx) != 0 || partialOperation(&txProcessingCtx))
+    {
+        display_operation_review();
+    }
+    resume_tx_stream();
+    if (pendingOperations(&txProcessingCtx) == 0 && !partialReview)
+    {
+        // waiting for the host to send the next operation
+        ui_idle();
+    }
+}
+
+unsigned int io_seproxyhal_touch_tx_ok(const bagl_element_t *e)
+{
+    // only approves hash signatures, whose digest is given by the host,
+    // transactions are finalized and signed by stream_tx
+    uint32_t tx = sign_hash_and_set_result();
+    txReplyPending = false;
+    io_exchange_with_code(0x9000, tx);
+    // Display back the original UX
+    ui_idle();
+
+    return 0; // do not redraw the widge
+}
+
+unsigned int io_seproxyhal_touch_tx_cancel(const bagl_element_t *e)
+{
+    // later chunks of a rejected transaction are refused
+    abortTx(&txProcessingCtx);
+    clear_prepared_keys();
+    if (txReplyPending)
     {
-      &C_icon_dashboard_x,
-      "Quit",
-    });
+        txReplyPending = false;
+        io_exchange_with_code(0x6985, 0);
+    }
+    // Display back the original UX
+    ui_idle();
+    return 0; // do not redraw the widget
+}
 
-UX_FLOW(
-    ux_idle_flow,
-    &ux_idle_flow_1_step,
-    &ux_idle_flow_2_step,
-    &ux_idle_flow_3_step,
-    &ux_idle_flow_4_step
-);
+#if defined(TARGET_NANOS)
 
-UX_FLOW_DEF_VALID(
-    ux_settings_flow_1_step,
-    bnnn,
-    switch_settings_contract_data(),
+unsigned int ui_single_action_tx_approval_nanos_button(unsigned int button_mask,
+                                      unsigned int button_mask_counter)
+{
+    switch (button_mask)
     {
-      "Contract data",
-      "Allow contract data",
-      "in transactions",
-      confirmLabel,
-    });
+    case BUTTON_EVT_RELEASED | BUTTON_LEFT:
+        io_seproxyhal_touch_tx_cancel(NULL);
+        break;
 
-UX_FLOW_DEF_VALID(
-    ux_settings_flow_2_step,
-    pb,
-    ui_idle(),
-    {
-      &C_icon_back_x,
-      "Back",
-    });
+    case BUTTON_EVT_RELEASED | BUTTON_RIGHT:
+        {
+            // Proceed to next ux_step if not at end
+            if(++ux_step < ux_step_count) {
+                if (ux_step >= 2) {
+                    showReviewPage(&reviewCache, &txProcessingCtx, ux_step - 2);
+                }
+                UX_REDISPLAY();
+                return 0;
+            }
+            // enabled once the whole operation has been hashed
+            if (partialReview) {
+                ux_step = ux_step_count - 1;
+                return 0;
+            }
 
-UX_FLOW(
-    ux_settings_flow, 
-    &ux_settings_flow_1_step,
-    &ux_settings_flow_2_step
-);
+            approve_operation();
+        }
+        break;
 
-void display_settings() {
-  strcpy(confirmLabel, (N_storage.dataAllowed ? "Allowed" : "NOT Allowed"));
-  ux_flow_init(0, ux_settings_flow, NULL);
+    }
+    return 0;
 }
 
-void switch_settings_contract_data() {
-  uint8_t value = (N_storage.dataAllowed ? 0 : 1);
-  nvm_write(&N_storage.dataAllowed, (void*)&value, sizeof(uint8_t));
-  display_settings();
+unsigned int ui_multiple_action_tx_approval_nanos_button(unsigned int button_mask,
+                                      unsigned int button_mask_counter) 
+{
+    switch (button_mask) 
+    {
+    case BUTTON_EVT_RELEASED | BUTTON_LEFT:
+        io_seproxyhal_touch_tx_cancel(NULL);
+        break;
+
+    case BUTTON_EVT_RELEASED | BUTTON_RIGHT:
+        {
+            resume_tx_stream();
+            if (pendingOperations(&txProcessingCtx) == 0 && !partialReview) {
+                ui_idle();
+            }
+        }
+    }
+
+    return 0;
 }
 
-///////////////////////////////////////////////////////////////////////////////
+unsigned int ui_hash_nanos_button(unsigned int button_mask,
+                                  unsigned int button_mask_counter)
+{
+    switch (button_mask)
+    {
+    case BUTTON_EVT_RELEASED | BUTTON_LEFT:
+        io_seproxyhal_touch_tx_cancel(NULL);
+        break;
 
-UX_FLOW_DEF_NOCB(
-    ux_display_public_flow_1_step,
-    pnn,
+    case BUTTON_EVT_RELEASED | BUTTON_RIGHT:
+        io_seproxyhal_touch_tx_ok(NULL);
+        break;
+    }
+    return 0;
+}
+
+unsigned int ui_session_nanos_button(unsigned int button_mask,
+                                     unsigned int button_mask_counter)
+{
+    switch (button_mask)
     {
-      &C_icon_eye,
-      "Verify",
-      "Public Key",
-    });
-UX_FLOW_DEF_NOCB(
-    ux_display_public_flow_2_step,
-    bnnn_paging,
+    case BUTTON_EVT_RELEASED | BUTTON_LEFT:
+        io_seproxyhal_touch_session_cancel(NULL);
+        break;
+
+    case BUTTON_EVT_RELEASED | BUTTON_RIGHT:
+        io_seproxyhal_touch_session_ok(NULL);
+        break;
+    }
+    return 0;
+}
+
+unsigned int ui_trust_nanos_button(unsigned int button_mask,
+                                   unsigned int button_mask_counter)
+{
+    switch (button_mask)
     {
-      .title = "Public Key",
-      .text = tmpCtx.publicKeyContext.address,
-    });
-UX_FLOW_DEF_VALID(
-    ux_display_public_flow_3_step,
-    pb,
-    io_seproxyhal_touch_address_ok(NULL),
+    case BUTTON_EVT_RELEASED | BUTTON_LEFT:
+        io_seproxyhal_touch_trust_cancel(NULL);
+        break;
+
+    case BUTTON_EVT_RELEASED | BUTTON_RIGHT:
+        io_seproxyhal_touch_trust_ok(NULL);
+        break;
+    }
+    return 0;
+}
+
+unsigned int ui_memo_nanos_button(unsigned int button_mask,
+                                  unsigned int button_mask_counter)
+{
+    switch (button_mask)
     {
-      &C_icon_validate_14,
-      "Approve",
-    });
-UX_FLOW_DEF_VALID(
-    ux_display_public_flow_4_step,
-    pb,
-    io_seproxyhal_touch_address_cancel(NULL),
+    case BUTTON_EVT_RELEASED | BUTTON_LEFT:
+        io_seproxyhal_touch_memo_cancel(NULL);
+        break;
+
+    case BUTTON_EVT_RELEASED | BUTTON_RIGHT:
+        io_seproxyhal_touch_memo_ok(NULL);
+        break;
+    }
+    return 0;
+}
+
+#endif // defined(TARGET_NANOS)
+
+void io_exchange_with_code(uint16_t code, uint32_t tx) {
+	G_io_apdu_buffer[tx++] = code >> 8;
+	G_io_apdu_buffer[tx++] = code & 0xFF;
+    // Send back the response, do not restart the event loop
+	io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, tx);
+}
+
+unsigned short io_exchange_al(unsigned char channel, unsigned short tx_len)
+{
+    switch (channel & ~(IO_FLAGS))
     {
-      &C_icon_crossmark,
-      "Reject",
-    });
+    case CHANNEL_KEYBOARD:
+        break;
 
-UX_FLOW(
-    ux_display_public_flow,
-    &ux_display_public_flow_1_step,
-    &ux_display_public_flow_2_step,
-    &ux_display_public_flow_3_step,
-    &ux_display_public_flow_4_step
-);
+    // multiplexed io exchange over a SPI channel and TLV encapsulated protocol
+    case CHANNEL_SPI:
+        if (tx_len)
+        {
+            io_seproxyhal_spi_send(G_io_apdu_buffer, tx_len);
 
-///////////////////////////////////////////////////////////////////////////////
+            if (channel & IO_RESET_AFTER_REPLIED)
+            {
+                reset();
+            }
+            return 0; // nothing received from the master so far (it's a tx
+                      // transaction)
+        }
+        else
+        {
+            return io_seproxyhal_spi_recv(G_io_apdu_buffer,
+                                          sizeof(G_io_apdu_buffer), 0);
+        }
 
-#define STATE_LEFT_BORDER 0
-#define STATE_VARIABLE 1
-#define STATE_RIGHT_BORDER 2
+    default:
+        THROW(INVALID_PARAMETER);
+    }
+    return 0;
+}
 
-volatile char confirm_text1[16];
-volatile char confirm_text2[16];
+uint32_t get_public_key_and_set_result()
+{
+    uint32_t tx = 0;
+    G_io_apdu_buffer[tx++] = 65;
+    os_memmove(G_io_apdu_buffer + tx, tmpCtx.publicKeyContext.publicKey.W, 65);
+    tx += 65;
 
-void display_next_state(uint8_t state);
-void ux_single_action_sign_flow_ok_pressed();
+    uint32_t addressLength = strlen(tmpCtx.publicKeyContext.address);
 
-UX_FLOW_DEF_NOCB(
-    ux_single_action_sign_flow_1_step,
-    pnn,
+    G_io_apdu_buffer[tx++] = addressLength;
+    os_memmove(G_io_apdu_buffer + tx, tmpCtx.publicKeyContext.address, addressLength);
+    tx += addressLength;
+    if (tmpCtx.publicKeyContext.getChaincode)
+    {
+        os_memmove(G_io_apdu_buffer + tx, tmpCtx.publicKeyContext.chainCode, 32);
+        tx += 32;
+    }
+    if (tmpCtx.publicKeyContext.getExtendedKey)
+    {
+        G_io_apdu_buffer[tx++] = tmpCtx.publicKeyContext.depth;
+        os_memmove(G_io_apdu_buffer + tx, tmpCtx.publicKeyContext.parentFingerprint, 4);
+        tx += 4;
+        G_io_apdu_buffer[tx++] = tmpCtx.publicKeyContext.childNumber >> 24;
+        G_io_apdu_buffer[tx++] = tmpCtx.publicKeyContext.childNumber >> 16;
+        G_io_apdu_buffer[tx++] = tmpCtx.publicKeyContext.childNumber >> 8;
+        G_io_apdu_buffer[tx++] = tmpCtx.publicKeyContext.childNumber;
+    }
+    return tx;
+}
+
+/**
+ * BIP 32 origin of an extended public key: its depth, the fingerprint of
+ * its parent key and its child number. With the chain code, the host can
+ * derive the non-hardened children of the key on its own.
+*/
+static void extended_key_origin(uint32_t *bip32Path, uint8_t bip32PathLength)
+{
+    uint8_t privateKeyData[32];
+    uint8_t compressed[33];
+    uint8_t hash[32];
+    uint8_t hash160[20];
+    cx_ecfp_private_key_t privateKey;
+    cx_ecfp_public_key_t publicKey;
+    cx_sha256_t parentSha256;
+    cx_ripemd160_t parentRipemd160;
+
+    tmpCtx.publicKeyContext.depth = bip32PathLength;
+    tmpCtx.publicKeyContext.childNumber = bip32Path[bip32PathLength - 1];
+    if (bip32PathLength == 1)
+    {
+        // children of the master key have no fingerprint to show
+        os_memset(tmpCtx.publicKeyContext.parentFingerprint, 0, 4);
+        return;
+    }
+
+    os_perso_derive_node_bip32(CX_CURVE_256K1, bip32Path, bip32PathLength - 1,
+                               privateKeyData, NULL);
+    cx_ecfp_init_private_key(CX_CURVE_256K1, privateKeyData, 32, &privateKey);
+    cx_ecfp_generate_pair(CX_CURVE_256K1, &publicKey, &privateKey, 1);
+    os_memset(&privateKey, 0, sizeof(privateKey));
+    os_memset(privateKeyData, 0, sizeof(privateKeyData));
+
+    compressed[0] = (publicKey.W[64] & 0x1) ? 0x03 : 0x02;
+    os_memmove(compressed + 1, publicKey.W + 1, 32);
+    cx_sha256_init(&parentSha256);
+    cx_hash(&parentSha256.header, CX_LAST, compressed, sizeof(compressed), hash, 32);
+    cx_ripemd160_init(&parentRipemd160);
+    cx_hash(&parentRipemd160.header, CX_LAST, hash, 32, hash160, sizeof(hash160));
+    os_memmove(tmpCtx.publicKeyContext.parentFingerprint, hash160, 4);
+}
+
+void handleGetPublicKey(uint8_t p1, uint8_t p2, uint8_t *dataBuffer,
+                        uint16_t dataLength, volatile unsigned int *flags,
+                        volatile unsigned int *tx)
+{
+    UNUSED(dataLength);
+    uint8_t privateKeyData[32];
+    uint32_t bip32Path[MAX_BIP32_PATH];
+    uint32_t i;
+    uint8_t bip32PathLength = *(dataBuffer++);
+    cx_ecfp_private_key_t privateKey;
+
+    if ((bip32PathLength < 0x01) || (bip32PathLength > MAX_BIP32_PATH))
     {
-      &C_icon_certificate,
-      "Review",
-      confirmLabel,
-    });
-UX_FLOW_DEF_NOCB(
-    ux_single_action_sign_flow_2_step,
-    bn,
+        PRINTF("Invalid path\n");
+        THROW(0x6a80);
+    }
+    if ((p1 != P1_CONFIRM) && (p1 != P1_NON_CONFIRM))
     {
-      "OP Type",
-      txContent.opName,
-    });
-UX_STEP_INIT(
-    ux_init_left_border,
-    NULL,
-    NULL,
+        THROW(0x6B00);
+    }
+    if ((p2 != P2_CHAINCODE) && (p2 != P2_NO_CHAINCODE) && (p2 != P2_EXTENDED_KEY))
     {
-        display_next_state(STATE_LEFT_BORDER);
-    });
-
-UX_STEP_NOCB_INIT(
-    ux_single_action_sign_flow_variable_step,
-    bnnn_paging,
+        THROW(0x6B00);
+    }
+    for (i = 0; i < bip32PathLength; i++)
     {
-        display_next_state(STATE_VARIABLE);
-    },
+        bip32Path[i] = (dataBuffer[0] << 24) | (dataBuffer[1] << 16) |
+                       (dataBuffer[2] << 8) | (dataBuffer[3]);
+        dataBuffer += 4;
+    }
+    // the paths of a transaction being signed are overwritten, drop it
+    if (partialReview || pendingOperations(&txProcessingCtx) != 0)
     {
-      .title = txContent.arg.label,
-      .text = txContent.arg.data,
-    });
-
-UX_STEP_INIT(
-    ux_init_right_border,
-    NULL,
-    NULL,
+        ui_idle();
+    }
+    abortTx(&txProcessingCtx);
+    clear_prepared_keys();
+    tmpCtx.publicKeyContext.getExtendedKey = (p2 == P2_EXTENDED_KEY);
+    if (tmpCtx.publicKeyContext.getExtendedKey)
     {
-        display_next_state(STATE_RIGHT_BORDER);
-    });
-
-UX_FLOW_DEF_VALID(
-    ux_single_action_sign_flow_6_step,
-    pbb,
-    ux_single_action_sign_flow_ok_pressed(),
+        extended_key_origin(bip32Path, bip32PathLength);
+    }
+    tmpCtx.publicKeyContext.getChaincode = (p2 == P2_CHAINCODE) || (p2 == P2_EXTENDED_KEY);
+    os_perso_derive_node_bip32(CX_CURVE_256K1, bip32Path, bip32PathLength,
+                               privateKeyData,
+                               (tmpCtx.publicKeyContext.getChaincode
+                                    ? tmpCtx.publicKeyContext.chainCode
+                                    : NULL));
+    cx_ecfp_init_private_key(CX_CURVE_256K1, privateKeyData, 32, &privateKey);
+    cx_ecfp_generate_pair(CX_CURVE_256K1, &tmpCtx.publicKeyContext.publicKey,
+                          &privateKey, 1);
+    os_memset(&privateKey, 0, sizeof(privateKey));
+    os_memset(privateKeyData, 0, sizeof(privateKeyData));
+    public_key_to_wif(tmpCtx.publicKeyContext.publicKey.W, sizeof(tmpCtx.publicKeyContext.publicKey.W),
+                      tmpCtx.publicKeyContext.address, sizeof(tmpCtx.publicKeyContext.address));
+    if (p1 == P1_NON_CONFIRM)
     {
-      &C_icon_validate_14,
-      confirm_text1,
-      confirm_text2,
-    });
-UX_FLOW_DEF_VALID(
-    ux_single_action_sign_flow_7_step,
-    pbb,
-    io_seproxyhal_touch_tx_cancel(NULL),
+        *tx = get_public_key_and_set_result();
+        THROW(0x9000);
+    }
+    else
     {
-      &C_icon_crossmark,
-      "Cancel",
-      "signature",
-    });
+#if defined(TARGET_NANOS)
+        // prepare for a UI based reply
+        ux_step = 0;
+        ux_step_count = 2;
+        UX_DISPLAY(ui_address_nanos, ui_address_prepro);
+#elif defined(TARGET_NANOX)
+        ux_flow_init(0, ux_display_public_flow, NULL);
+#endif
 
-UX_FLOW(
-    ux_single_action_sign_flow, 
-    &ux_single_action_sign_flow_1_step,
-    &ux_single_action_sign_flow_2_step,
-    &ux_init_left_border,
-    &ux_single_action_sign_flow_variable_step,
-    &ux_init_right_border,
-    &ux_single_action_sign_flow_6_step,
-    &ux_single_action_sign_flow_7_step
-);
+        *flags |= IO_ASYNCH_REPLY;
+    }
+}
 
-void display_next_state(uint8_t state) 
-{    
-    if (state == STATE_LEFT_BORDER)
+/**
+ * Derive every key of a path template over an index range and report
+ * the ones matching one of the host supplied compressed public keys.
+ * The last path element is the one iterated, its hardened bit is kept.
+*/
+void handleFindPublicKeys(uint8_t p1, uint8_t p2, uint8_t *dataBuffer,
+                          uint16_t dataLength, volatile unsigned int *flags,
+                          volatile unsigned int *tx)
+{
+    UNUSED(flags);
+    uint8_t privateKeyData[32];
+    uint8_t targets[MAX_FIND_TARGETS * 33];
+    uint8_t numTargets;
+    uint8_t targetCount = 0;
+    uint32_t bip32Path[MAX_BIP32_PATH];
+    uint8_t bip32PathLength;
+    uint32_t firstIndex;
+    uint16_t count;
+    uint8_t found = 0;
+    uint32_t i, j;
+    cx_ecfp_private_key_t privateKey;
+    cx_ecfp_public_key_t publicKey;
+
+    if ((p1 != 0) || (p2 != 0))
     {
-        if (ux_step == 0)
-        {
-            ux_step = 1;
-            ux_flow_next();
-        }
-        else if (ux_step == 1) 
-        {
-            --ux_step;
-            ux_flow_prev();
-        }
-        else if (ux_step > 1)
-        {
-            --ux_step;
-            ux_flow_next();
-        }
+        THROW(0x6B00);
     }
-    else if (state == STATE_VARIABLE)
+    if (dataLength < 1)
     {
-        printArgument(ux_step-1, &txProcessingCtx);
+        THROW(0x6700);
     }
-    else if (state == STATE_RIGHT_BORDER)
+    numTargets = *(dataBuffer++);
+    dataLength--;
+    if ((numTargets < 1) || (numTargets > MAX_FIND_TARGETS))
     {
-        if (ux_step < ux_step_count)
-        {
-            ++ux_step;
-            ux_flow_prev();
-        }
-        else if (ux_step == ux_step_count)
+        PRINTF("Invalid number of targets\n");
+        THROW(0x6a80);
+    }
+    if (dataLength < numTargets * 33 + 1)
+    {
+        THROW(0x6700);
+    }
+    // matches are written over the input, keep a copy of the targets,
+    // each of them once so that the scan stops once all are found
+    for (i = 0; i < numTargets; i++)
+    {
+        for (j = 0; j < targetCount; j++)
         {
-            ++ux_step;
-            ux_flow_next();
+            if (os_memcmp(targets + j * 33, dataBuffer + i * 33, 33) == 0)
+            {
+                break;
+            }
         }
-        else if (ux_step > ux_step_count)
+        if (j == targetCount)
         {
-            ux_step = ux_step_count;
-            ux_flow_prev();
-        }
-    }
-}
-
-void ux_single_action_sign_flow_ok_pressed() 
-{
-    parserStatus_e txResult = parseTx(&txProcessingCtx, NULL, 0);
-    switch (txResult) {
-    case STREAM_ACTION_READY:
-        ux_step = 0;
-        ux_step_count = 1 + txContent.argumentCount;
-        if (txProcessingCtx.numOperations > 1) {
-            snprintf((char *)confirmLabel, sizeof(confirmLabel), "OP #%d", txProcessingCtx.currentOpIndex);
-        }
-        strcpy((char *)confirm_text1, txProcessingCtx.currentOpIndex == txProcessingCtx.numOperations ? "Sign" : "Accept");
-        strcpy((char *)confirm_text2, txProcessingCtx.currentOpIndex == txProcessingCtx.numOperations ? "transaction" : "and review next");
-
-        ux_flow_init(0, ux_single_action_sign_flow, NULL);
-        break;
-    case STREAM_PROCESSING:
-        io_exchange_with_code(0x9000, 0);
-        // Display back the original UX
-        ui_idle();
-        break;
-    case STREAM_FINISHED:
-        if(++ux_step < ux_step_count) {
-            printArgument(ux_step, &txProcessingCtx);
-            UX_REDISPLAY();
-            return 0;
+            os_memmove(targets + targetCount * 33, dataBuffer + i * 33, 33);
+            targetCount++;
         }
-
-        io_seproxyhal_touch_tx_ok(NULL);
-        break;
-    default:
-        io_exchange_with_code(0x6A80, 0);
-        // Display back the original UX
-        ui_idle();
-        break;
     }
-}
-
-
-///////////////////////////////////////////////////////////////////////////////
-
-void ux_multiple_action_sign_flow_ok_pressed();
+    dataBuffer += numTargets * 33;
+    dataLength -= numTargets * 33;
 
-UX_FLOW_DEF_NOCB(
-    ux_multiple_action_sign_flow_1_step,
-    pnn,
+    bip32PathLength = *(dataBuffer++);
+    dataLength--;
+    if ((bip32PathLength < 0x01) || (bip32PathLength > MAX_BIP32_PATH))
     {
-      &C_icon_certificate,
-      "Review",
-      "Transaction",
-    });
-UX_FLOW_DEF_NOCB(
-    ux_multiple_action_sign_flow_2_step,
-    bn, //pnn,
+        PRINTF("Invalid path\n");
+        THROW(0x6a80);
+    }
+    if (dataLength != bip32PathLength * 4 + 2)
     {
-      "With",
-      actionCounter,
-    });
-UX_FLOW_DEF_VALID(
-    ux_multiple_action_sign_flow_3_step,
-    pbb,
-    ux_multiple_action_sign_flow_ok_pressed(),
+        THROW(0x6700);
+    }
+    for (i = 0; i < bip32PathLength; i++)
     {
-      &C_icon_validate_14,
-      "Continue",
-      "review"
-    });
-UX_FLOW_DEF_VALID(
-    ux_multiple_action_sign_flow_4_step,
-    pbb,
-    io_seproxyhal_touch_tx_cancel(NULL),
+        bip32Path[i] = (dataBuffer[0] << 24) | (dataBuffer[1] << 16) |
+                       (dataBuffer[2] << 8) | (dataBuffer[3]);
+        dataBuffer += 4;
+    }
+    count = (dataBuffer[0] << 8) | dataBuffer[1];
+    firstIndex = bip32Path[bip32PathLength - 1];
+    if ((count < 1) || (count > MAX_FIND_COUNT) ||
+        (((firstIndex + count - 1) & 0x80000000) != (firstIndex & 0x80000000)))
     {
-      &C_icon_crossmark,
-      "Cancel",
-      "review",
-    });
+        PRINTF("Invalid index range\n");
+        THROW(0x6a80);
+    }
 
-UX_FLOW(
-    ux_multiple_action_sign_flow, 
-    &ux_multiple_action_sign_flow_1_step,
-    &ux_multiple_action_sign_flow_2_step,
-    &ux_multiple_action_sign_flow_3_step,
-    &ux_multiple_action_sign_flow_4_step
-);
+    G_io_apdu_buffer[(*tx)++] = 0;
+    for (i = 0; (i < count) && (found < targetCount); i++)
+    {
+        bip32Path[bip32PathLength - 1] = firstIndex + i;
+        os_perso_derive_node_bip32(CX_CURVE_256K1, bip32Path, bip32PathLength,
+                                   privateKeyData, NULL);
+        cx_ecfp_init_private_key(CX_CURVE_256K1, privateKeyData, 32, &privateKey);
+        cx_ecfp_generate_pair(CX_CURVE_256K1, &publicKey, &privateKey, 1);
+        os_memset(&privateKey, 0, sizeof(privateKey));
+        os_memset(privateKeyData, 0, sizeof(privateKeyData));
+
+        for (j = 0; j < targetCount; j++)
+        {
+            uint8_t *target = targets + j * 33;
+            if ((target[0] == ((publicKey.W[64] & 0x1) ? 0x03 : 0x02)) &&
+                (os_memcmp(target + 1, publicKey.W + 1, 32) == 0))
+            {
+                os_memmove(G_io_apdu_buffer + *tx, target, 33);
+                *tx += 33;
+                G_io_apdu_buffer[(*tx)++] = bip32Path[bip32PathLength - 1] >> 24;
+                G_io_apdu_buffer[(*tx)++] = bip32Path[bip32PathLength - 1] >> 16;
+                G_io_apdu_buffer[(*tx)++] = bip32Path[bip32PathLength - 1] >> 8;
+                G_io_apdu_buffer[(*tx)++] = bip32Path[bip32PathLength - 1];
+                found++;
+                break;
+            }
+        }
+    }
+    G_io_apdu_buffer[0] = found;
+    // where the host resumes the scan with another command
+    G_io_apdu_buffer[(*tx)++] = (firstIndex + i) >> 24;
+    G_io_apdu_buffer[(*tx)++] = (firstIndex + i) >> 16;
+    G_io_apdu_buffer[(*tx)++] = (firstIndex + i) >> 8;
+    G_io_apdu_buffer[(*tx)++] = (firstIndex + i);
+    THROW(0x9000);
+}
 
-void ux_multiple_action_sign_flow_ok_pressed()
+void handleGetAppConfiguration(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
+                               uint16_t dataLength,
+                               volatile unsigned int *flags,
+                               volatile unsigned int *tx)
 {
-    parserStatus_e txResult = parseTx(&txProcessingCtx, NULL, 0);
-    switch (txResult) {
-    case STREAM_ACTION_READY:
-        ux_step = 0;
-        ux_step_count = txContent.argumentCount;
-        // TODO: proper redisplya
-        // UX_REDISPLAY();
-        break;
-    case STREAM_PROCESSING:
-        io_exchange_with_code(0x9000, 0);
-        // Display back the original UX
-        ui_idle();
-        break;
-    case STREAM_FINISHED:
-        io_seproxyhal_touch_tx_ok(NULL);
-        break;
-    default:
-        io_exchange_with_code(0x6A80, 0);
-        // Display back the original UX
-        ui_idle();
-        break;
-    }
+    UNUSED(p1);
+    UNUSED(p2);
+    UNUSED(workBuffer);
+    UNUSED(dataLength);
+    UNUSED(flags);
+    G_io_apdu_buffer[0] = (N_storage.dataAllowed ? 0x01 : 0x00) |
+                          (N_storage.hashSignAllowed ? 0x02 : 0x00) |
+                          (N_storage.compactReview ? 0x04 : 0x00);
+    G_io_apdu_buffer[1] = LEDGER_MAJOR_VERSION;
+    G_io_apdu_buffer[2] = LEDGER_MINOR_VERSION;
+    G_io_apdu_buffer[3] = LEDGER_PATCH_VERSION;
+    *tx = 4;
+    THROW(0x9000);
 }
 
-#endif // #if defined(TARGET_NANOX)
-
-void ui_idle(void)
+static void derive_signing_key(uint8_t path, cx_ecfp_private_key_t *privateKey)
 {
-#if defined(TARGET_NANOS)
-    UX_MENU_DISPLAY(0, menu_main, NULL);
-#elif defined(TARGET_NANOX)
-    // reserve a display stack slot if none yet
-    if(G_ux.stack_count == 0) {
-        ux_stack_push();
-    }
-    ux_flow_init(0, ux_idle_flow, NULL);
-#endif
-}
+    uint8_t privateKeyData[64];
 
-unsigned int io_seproxyhal_touch_exit(const bagl_element_t *e)
-{
-    // Go back to the dashboard
-    os_sched_exit(0);
-    return 0; // do not redraw the widget
+    os_perso_derive_node_bip32(
+        CX_CURVE_256K1, tmpCtx.transactionContext.bip32Path[path],
+        tmpCtx.transactionContext.pathLength[path], privateKeyData, NULL);
+    cx_ecfp_init_private_key(CX_CURVE_256K1, privateKeyData, 32, privateKey);
+    os_memset(privateKeyData, 0, sizeof(privateKeyData));
 }
 
-unsigned int io_seproxyhal_touch_address_ok(const bagl_element_t *e)
+/**
+ * Derive the key of the next signing path while the user reviews, so that
+ * the approval only has to sign. Returns false once there is none left.
+*/
+bool prepare_signing_key_step(void)
 {
-    uint32_t tx = get_public_key_and_set_result();
-    io_exchange_with_code(0x9000, tx);
-    // Display back the original UX
-    ui_idle();
-    return 0; // do not redraw the widget
+    // only for a transaction or a hash still waiting to be signed
+    if (!preparedKeys.requested || sessionTx ||
+        (txProcessingCtx.state == TLV_NONE && !txReplyPending) ||
+        preparedKeys.count >= tmpCtx.transactionContext.pathCount ||
+        preparedKeys.count == PREPARED_KEYS)
+    {
+        return false;
+    }
+    derive_signing_key(preparedKeys.count, &preparedKeys.keys[preparedKeys.count]);
+    preparedKeys.count++;
+    return true;
 }
 
-unsigned int io_seproxyhal_touch_address_cancel(const bagl_element_t *e)
+/**
+ * Wipe the prepared keys, when the transaction is signed, rejected or
+ * dropped, and before its paths are replaced.
+*/
+void clear_prepared_keys(void)
 {
-    io_exchange_with_code(0x6985, 0);
-    // Display back the original UX
-    ui_idle();
-    return 0; // do not redraw the widget
+    os_memset(&preparedKeys, 0, sizeof(preparedKeys));
 }
 
-#if defined(TARGET_NANOS)
-unsigned int ui_address_nanos_button(unsigned int button_mask,
-                                     unsigned int button_mask_counter)
+uint32_t sign_hash_and_set_result(void) 
 {
-    switch (button_mask)
-    {
-    case BUTTON_EVT_RELEASED | BUTTON_LEFT: // CANCEL
-        io_seproxyhal_touch_address_cancel(NULL);
-        break;
+    cx_ecfp_private_key_t privateKey;
+    uint32_t tries;
+    uint8_t i;
 
-    case BUTTON_EVT_RELEASED | BUTTON_RIGHT:
-    { // OK
-        io_seproxyhal_touch_address_ok(NULL);
-        break;
+    // the paths share tmpCtx with the public key context
+    if ((tmpCtx.transactionContext.pathCount < 1) ||
+        (tmpCtx.transactionContext.pathCount > MAX_SIGN_PATHS))
+    {
+        PRINTF("Invalid number of paths\n");
+        clear_prepared_keys();
+        THROW(0x6a80);
     }
+    // one signature per path, all over the same digest
+    for (i = 0; i < tmpCtx.transactionContext.pathCount; i++)
+    {
+        if (i < preparedKeys.count)
+        {
+            os_memmove(&privateKey, &preparedKeys.keys[i], sizeof(privateKey));
+        }
+        else
+        {
+            derive_signing_key(i, &privateKey);
+        }
+
+        tries = hive_sign_digest(&privateKey, tmpCtx.transactionContext.hash,
+                                 G_io_apdu_buffer + i * HIVE_SIGNATURE_LENGTH);
+        PRINTF("Canonical signature found after %d retries\n", tries);
+
+        os_memset(&privateKey, 0, sizeof(privateKey));
     }
-    return 0;
+    clear_prepared_keys();
+
+    return tmpCtx.transactionContext.pathCount * HIVE_SIGNATURE_LENGTH;
 }
-#endif // ui_address_nanos_button
 
-unsigned int io_seproxyhal_touch_tx_ok(const bagl_element_t *e)
+void handleSign(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
+                uint16_t dataLength, volatile unsigned int *flags,
+                volatile unsigned int *tx)
 {
-    uint32_t tx = sign_hash_and_set_result();
-    io_exchange_with_code(0x9000, tx);
-    // Display back the original UX
-    ui_idle();
+    uint32_t i, j;
+    if (p1 == P1_FIRST)
+    {
+        clear_prepared_keys();
+        bool compressed = (p2 & P2_COMPRESSED) != 0;
+        bool templated = (p2 & P2_TEMPLATE) != 0;
+        hiveTemplate_t *template = NULL;
+        if (compressed && templated)
+        {
+            THROW(0x6B00);
+        }
+        p2 &= ~(P2_COMPRESSED | P2_TEMPLATE);
+        if (p2 == P2_MULTIPLE_PATHS)
+        {
+            if (dataLength < 1)
+            {
+                THROW(0x6700);
+            }
+            tmpCtx.transactionContext.pathCount = workBuffer[0];
+            workBuffer++;
+            dataLength--;
+        }
+        else if (p2 == P2_SINGLE_PATH)
+        {
+            tmpCtx.transactionContext.pathCount = 1;
+        }
+        else
+        {
+            THROW(0x6B00);
+        }
+        if ((tmpCtx.transactionContext.pathCount < 1) ||
+            (tmpCtx.transactionContext.pathCount > MAX_SIGN_PATHS))
+        {
+            PRINTF("Invalid number of paths\n");
+            THROW(0x6a80);
+        }
+        for (j = 0; j < tmpCtx.transactionContext.pathCount; j++)
+        {
+            if (dataLength < 1)
+            {
+                THROW(0x6700);
+            }
+            tmpCtx.transactionContext.pathLength[j] = workBuffer[0];
+            if ((tmpCtx.transactionContext.pathLength[j] < 0x01) ||
+                (tmpCtx.transactionContext.pathLength[j] > MAX_BIP32_PATH))
+            {
+                PRINTF("Invalid path\n");
+                THROW(0x6a80);
+            }
+            workBuffer++;
+            dataLength--;
+            if (dataLength < tmpCtx.transactionContext.pathLength[j] * 4)
+            {
+                THROW(0x6700);
+            }
+            for (i = 0; i < tmpCtx.transactionContext.pathLength[j]; i++)
+            {
+                tmpCtx.transactionContext.bip32Path[j][i] =
+                    (workBuffer[0] << 24) | (workBuffer[1] << 16) |
+                    (workBuffer[2] << 8) | (workBuffer[3]);
+                workBuffer += 4;
+                dataLength -= 4;
+            }
+        }
+        if (templated)
+        {
+            if (dataLength < 1)
+            {
+                THROW(0x6700);
+            }
+            if ((workBuffer[0] >= HIVE_TEMPLATES) || !hiveTemplates[workBuffer[0]].used)
+            {
+                PRINTF("Unknown template\n");
+                THROW(0x6a80);
+            }
+            template = &hiveTemplates[workBuffer[0]];
+            workBuffer++;
+            dataLength--;
+        }
+        initTxContext(&txProcessingCtx, &sha256, &txContent, N_storage.dataAllowed, compressed, template);
+        initReviewCache(&reviewCache);
+        partialReview = false;
+        preparedKeys.requested = true;
+        sessionPathTx = (tmpCtx.transactionContext.pathCount == 1) &&
+                        hive_session_matches_path(&hiveSession,
+                                                  tmpCtx.transactionContext.pathLength[0],
+                                                  tmpCtx.transactionContext.bip32Path[0]);
+        sessionTx = sessionPathTx && !sessionReviewNext;
+        sessionReviewNext = false;
+        hive_session_begin_tx(&hiveSession);
+    }
+    else if (p1 != P1_MORE)
+    {
+        THROW(0x6B00);
+    }
+    else if (p2 != 0)
+    {
+        THROW(0x6B00);
+    }
+    if (txProcessingCtx.state == TLV_NONE)
+    {
+        PRINTF("Parser not initialized\n");
+        THROW(0x6985);
+    }
 
-    return 0; // do not redraw the widge
+    uint32_t txLength = 0;
+    uint16_t sw = stream_tx(workBuffer, dataLength, &txLength);
+    if (sw == 0)
+    {
+        txReplyPending = true;
+        *flags |= IO_ASYNCH_REPLY;
+        return;
+    }
+    *tx = txLength;
+    THROW(sw);
 }
 
-unsigned int io_seproxyhal_touch_tx_cancel(const bagl_element_t *e)
+/**
+ * Sign a digest computed by the host. Only available when enabled in the
+ * settings, the user approves the digest itself as no data is shown.
+*/
+void handleSignHash(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
+                    uint16_t dataLength, volatile unsigned int *flags,
+                    volatile unsigned int *tx)
 {
-    io_exchange_with_code(0x6985, 0);
-    // Display back the original UX
-    ui_idle();
-    return 0; // do not redraw the widget
-}
+    uint32_t i;
+    UNUSED(tx);
+
+    if ((p1 != 0) || (p2 != 0))
+    {
+        THROW(0x6B00);
+    }
+    if (!N_storage.hashSignAllowed)
+    {
+        PRINTF("Hash signing not allowed\n");
+        THROW(0x6985);
+    }
+    if (dataLength < 1)
+    {
+        THROW(0x6700);
+    }
+    // any transaction being streamed is dropped
+    abortTx(&txProcessingCtx);
+    initReviewCache(&reviewCache);
+    partialReview = false;
+    clear_prepared_keys();
+
+    tmpCtx.transactionContext.pathCount = 1;
+    tmpCtx.transactionContext.pathLength[0] = workBuffer[0];
+    if ((tmpCtx.transactionContext.pathLength[0] < 0x01) ||
+        (tmpCtx.transactionContext.pathLength[0] > MAX_BIP32_PATH))
+    {
+        PRINTF("Invalid path\n");
+        THROW(0x6a80);
+    }
+    workBuffer++;
+    dataLength--;
+    if (dataLength != tmpCtx.transactionContext.pathLength[0] * 4 + sizeof(tmpCtx.transactionContext.hash))
+    {
+        THROW(0x6700);
+    }
+    for (i = 0; i < tmpCtx.transactionContext.pathLength[0]; i++)
+    {
+        tmpCtx.transactionContext.bip32Path[0][i] =
+            (workBuffer[0] << 24) | (workBuffer[1] << 16) |
+            (workBuffer[2] << 8) | (workBuffer[3]);
+        workBuffer += 4;
+    }
+    os_memmove(tmpCtx.transactionContext.hash, workBuffer, sizeof(tmpCtx.transactionContext.hash));
+    for (i = 0; i < 4; i++)
+    {
+        array_hexstr((char *)hashChunks[i], tmpCtx.transactionContext.hash + i * 8, 8);
+    }
 
 #if defined(TARGET_NANOS)
+    ux_step = 0;
+    ux_step_count = 5;
+    UX_DISPLAY(ui_hash_nanos, ui_hash_prepro);
+#elif defined(TARGET_NANOX)
+    ux_flow_init(0, ux_sign_hash_flow, NULL);
+#endif
 
-unsigned int ui_single_action_tx_approval_nanos_button(unsigned int button_mask,
-                                      unsigned int button_mask_counter)
+    preparedKeys.requested = true;
+    txReplyPending = true;
+    *flags |= IO_ASYNCH_REPLY;
+}
+
+/**
+ * Start, end or query the signing session. Starting one needs the user
+ * approval, ending and querying it do not.
+*/
+void handleSession(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
+                   uint16_t dataLength, volatile unsigned int *flags,
+                   volatile unsigned int *tx)
 {
-    switch (button_mask)
+    uint8_t i;
+
+    switch (p1)
     {
-    case BUTTON_EVT_RELEASED | BUTTON_LEFT:
-        io_seproxyhal_touch_tx_cancel(NULL);
-        break;
+    case P1_SESSION_START:
+        if (p2 != P2_SESSION_POSTING && p2 != P2_SESSION_WITNESS)
+        {
+            THROW(0x6B00);
+        }
+        if (hive_session_parse(&hiveSession, (hiveSessionKind_e)p2, workBuffer, dataLength) != dataLength)
+        {
+            hive_session_revoke(&hiveSession);
+            THROW(0x6a80);
+        }
 
-    case BUTTON_EVT_RELEASED | BUTTON_RIGHT:
+        sessionAccounts[0] = '\0';
+        for (i = 0; i < hiveSession.accountCount; i++)
         {
-            // Proceed to next ux_step if not at end
-            if(++ux_step < ux_step_count) {
-                printArgument(ux_step, &txProcessingCtx);
-                UX_REDISPLAY();
-                return 0;
+            if (i > 0)
+            {
+                strcat((char *)sessionAccounts, ", ");
             }
-
-            parserStatus_e txResult = parseTx(&txProcessingCtx, NULL, 0);
-            switch (txResult) {
-            case STREAM_ACTION_READY:
-                ux_step = 0;
-                ux_step_count = 2 + txContent.argumentCount;
-                if (txProcessingCtx.numOperations > 1) {
-                    snprintf((char *)confirmLabel, sizeof(confirmLabel), "OP #%d", txProcessingCtx.currentOpIndex);
+            strcat((char *)sessionAccounts, hiveSession.accounts[i]);
+        }
+        if (hiveSession.kind == HIVE_SESSION_WITNESS)
+        {
+            strcpy((char *)sessionTitle, "Witness session");
+            snprintf((char *)sessionOperations, sizeof(sessionOperations), "feed_publish %d.%02d%%",
+                     hiveSession.bandBps / 100, hiveSession.bandBps % 100);
+        }
+        else
+        {
+            strcpy((char *)sessionTitle, "Posting session");
+            sessionOperations[0] = '\0';
+            for (i = 0; i < hiveSession.opTypeCount; i++)
+            {
+                if (i > 0)
+                {
+                    strcat((char *)sessionOperations, ", ");
                 }
-                UX_REDISPLAY();
-                break;
-            case STREAM_PROCESSING:
-                io_exchange_with_code(0x9000, 0);
-                // Display back the original UX
-                ui_idle();
-                break;
-            case STREAM_FINISHED:
-                io_seproxyhal_touch_tx_ok(NULL);
-                break;
-            default:
-                io_exchange_with_code(0x6A80, 0);
-                // Display back the original UX
-                ui_idle();
-                break;
+                strcat((char *)sessionOperations, hiveSession.opTypes[i] == 0 ? "vote" : "custom_json");
             }
         }
-        break;
-
-    }
-    return 0;
-}
+        snprintf((char *)sessionStatus, sizeof(sessionStatus), "%d sigs, %d min",
+                 hiveSession.signaturesLeft, hive_session_minutes_left(&hiveSession));
 
-unsigned int ui_multiple_action_tx_approval_nanos_button(unsigned int button_mask,
-                                      unsigned int button_mask_counter) 
-{
-    switch (button_mask) 
-    {
-    case BUTTON_EVT_RELEASED | BUTTON_LEFT:
-        io_seproxyhal_touch_tx_cancel(NULL);
+#if defined(TARGET_NANOS)
+        ux_step = 0;
+        ux_step_count = 4;
+        UX_DISPLAY(ui_session_nanos, ui_session_prepro);
+#elif defined(TARGET_NANOX)
+        ux_flow_init(0, ux_start_session_flow, NULL);
+#endif
+        approvalPending = true;
+        *flags |= IO_ASYNCH_REPLY;
         break;
 
-    case BUTTON_EVT_RELEASED | BUTTON_RIGHT:
+    case P1_SESSION_END:
+        if (p2 != 0)
         {
-            parserStatus_e txResult = parseTx(&txProcessingCtx, NULL, 0);
-            switch (txResult) {
-            case STREAM_ACTION_READY:
-                ux_step = 0;
-                ux_step_count = txContent.argumentCount;
-                UX_REDISPLAY();
-                break;
-            case STREAM_PROCESSING:
-                io_exchange_with_code(0x9000, 0);
-                // Display back the original UX
-                ui_idle();
-                break;
-            case STREAM_FINISHED:
-                io_seproxyhal_touch_tx_ok(NULL);
-                break;
-            default:
-                io_exchange_with_code(0x6A80, 0);
-                // Display back the original UX
-                ui_idle();
-                break;
-            }
+            THROW(0x6B00);
         }
-    }
-
-    return 0;
-}
+        hive_session_revoke(&hiveSession);
+        refresh_session_status();
+        UX_REDISPLAY();
+        THROW(0x9000);
 
-#endif // defined(TARGET_NANOS)
+    case P1_SESSION_STATUS:
+        if (p2 != 0)
+        {
+            THROW(0x6B00);
+        }
+        G_io_apdu_buffer[0] = hiveSession.active;
+        G_io_apdu_buffer[1] = hiveSession.signaturesLeft >> 8;
+        G_io_apdu_buffer[2] = hiveSession.signaturesLeft;
+        G_io_apdu_buffer[3] = hive_session_minutes_left(&hiveSession) >> 8;
+        G_io_apdu_buffer[4] = hive_session_minutes_left(&hiveSession);
+        G_io_apdu_buffer[5] = hiveSession.kind;
+        *tx = 6;
+        THROW(0x9000);
 
-void io_exchange_with_code(uint16_t code, uint32_t tx) {
-	G_io_apdu_buffer[tx++] = code >> 8;
-	G_io_apdu_buffer[tx++] = code & 0xFF;
-    // Send back the response, do not restart the event loop
-	io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, tx);
+    default:
+        THROW(0x6B00);
+    }
 }
 
-unsigned short io_exchange_al(unsigned char channel, unsigned short tx_len)
+/**
+ * Manage the trusted recipients. Adding names needs the user approval,
+ * removing, listing and clearing them do not, as they only take trust
+ * away or disclose it.
+*/
+void handleAddressBook(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
+                       uint16_t dataLength, volatile unsigned int *flags,
+                       volatile unsigned int *tx)
 {
-    switch (channel & ~(IO_FLAGS))
+    uint8_t i;
+
+    switch (p1)
     {
-    case CHANNEL_KEYBOARD:
-        break;
+    case P1_ADDRESS_BOOK_ADD:
+        if (p2 != 0)
+        {
+            THROW(0x6B00);
+        }
+        if ((dataLength == 0) || (hive_address_book_parse(&trustBatch, workBuffer, dataLength) != dataLength))
+        {
+            THROW(0x6a80);
+        }
+        hive_address_book_drop_known(&trustBatch);
+        if (trustBatch.count == 0)
+        {
+            THROW(0x9000);
+        }
+        if (hive_address_book_count() + trustBatch.count > ADDRESS_BOOK_SIZE)
+        {
+            PRINTF("Address book full\n");
+            THROW(0x6a84);
+        }
 
-    // multiplexed io exchange over a SPI channel and TLV encapsulated protocol
-    case CHANNEL_SPI:
-        if (tx_len)
+        snprintf((char *)trustTitle, sizeof(trustTitle), "%d recipient%s",
+                 trustBatch.count, trustBatch.count > 1 ? "s" : "");
+        trustAccounts[0] = '\0';
+        for (i = 0; i < trustBatch.count; i++)
         {
-            io_seproxyhal_spi_send(G_io_apdu_buffer, tx_len);
+            char name[ADDRESS_BOOK_NAME_LENGTH + 1];
 
-            if (channel & IO_RESET_AFTER_REPLIED)
+            if (i > 0)
             {
-                reset();
+                strcat((char *)trustAccounts, ", ");
             }
-            return 0; // nothing received from the master so far (it's a tx
-                      // transaction)
+            os_memmove(name, trustBatch.names[i], ADDRESS_BOOK_NAME_LENGTH);
+            name[ADDRESS_BOOK_NAME_LENGTH] = '\0';
+            strcat((char *)trustAccounts, name);
+        }
+
+#if defined(TARGET_NANOS)
+        ux_step = 0;
+        ux_step_count = 2;
+        UX_DISPLAY(ui_trust_nanos, ui_trust_prepro);
+#elif defined(TARGET_NANOX)
+        ux_flow_init(0, ux_trust_flow, NULL);
+#endif
+        approvalPending = true;
+        *flags |= IO_ASYNCH_REPLY;
+        break;
+
+    case P1_ADDRESS_BOOK_REMOVE:
+        if (p2 != 0)
+        {
+            THROW(0x6B00);
         }
-        else
+        if ((dataLength == 0) || (hive_address_book_parse(&trustBatch, workBuffer, dataLength) != dataLength))
         {
-            return io_seproxyhal_spi_recv(G_io_apdu_buffer,
-                                          sizeof(G_io_apdu_buffer), 0);
+            THROW(0x6a80);
         }
+        hive_address_book_remove(&trustBatch);
+        os_memset(&trustBatch, 0, sizeof(trustBatch));
+        THROW(0x9000);
 
-    default:
-        THROW(INVALID_PARAMETER);
-    }
-    return 0;
-}
-
-uint32_t get_public_key_and_set_result()
-{
-    uint32_t tx = 0;
-    G_io_apdu_buffer[tx++] = 65;
-    os_memmove(G_io_apdu_buffer + tx, tmpCtx.publicKeyContext.publicKey.W, 65);
-    tx += 65;
+    case P1_ADDRESS_BOOK_LIST:
+        G_io_apdu_buffer[0] = hive_address_book_count();
+        *tx = 1 + hive_address_book_list(p2, G_io_apdu_buffer + 1, 200);
+        THROW(0x9000);
 
-    uint32_t addressLength = strlen(tmpCtx.publicKeyContext.address);
+    case P1_ADDRESS_BOOK_CLEAR:
+        if (p2 != 0)
+        {
+            THROW(0x6B00);
+        }
+        hive_address_book_clear();
+        THROW(0x9000);
 
-    G_io_apdu_buffer[tx++] = addressLength;
-    os_memmove(G_io_apdu_buffer + tx, tmpCtx.publicKeyContext.address, addressLength);
-    tx += addressLength;
-    if (tmpCtx.publicKeyContext.getChaincode)
-    {
-        os_memmove(G_io_apdu_buffer + tx, tmpCtx.publicKeyContext.chainCode, 32);
-        tx += 32;
+    default:
+        THROW(0x6B00);
     }
-    return tx;
 }
 
-void handleGetPublicKey(uint8_t p1, uint8_t p2, uint8_t *dataBuffer,
-                        uint16_t dataLength, volatile unsigned int *flags,
-                        volatile unsigned int *tx)
+/**
+ * Decrypt memos addressed to or sent from a memo key. Starting a batch
+ * needs the user approval, the key is then derived once and used for the
+ * records of the following commands until the batch ends.
+*/
+void handleDecryptMemo(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
+                       uint16_t dataLength, volatile unsigned int *flags,
+                       volatile unsigned int *tx)
 {
-    UNUSED(dataLength);
-    uint8_t privateKeyData[32];
-    uint32_t bip32Path[MAX_BIP32_PATH];
-    uint32_t i;
-    uint8_t bip32PathLength = *(dataBuffer++);
-    cx_ecfp_private_key_t privateKey;
+    uint8_t i;
 
-    if ((bip32PathLength < 0x01) || (bip32PathLength > MAX_BIP32_PATH))
-    {
-        PRINTF("Invalid path\n");
-        THROW(0x6a80);
-    }
-    if ((p1 != P1_CONFIRM) && (p1 != P1_NON_CONFIRM))
-    {
-        THROW(0x6B00);
-    }
-    if ((p2 != P2_CHAINCODE) && (p2 != P2_NO_CHAINCODE))
+    if (p2 != 0)
     {
         THROW(0x6B00);
     }
-    for (i = 0; i < bip32PathLength; i++)
-    {
-        bip32Path[i] = (dataBuffer[0] << 24) | (dataBuffer[1] << 16) |
-                       (dataBuffer[2] << 8) | (dataBuffer[3]);
-        dataBuffer += 4;
-    }
-    tmpCtx.publicKeyContext.getChaincode = (p2 == P2_CHAINCODE);
-    os_perso_derive_node_bip32(CX_CURVE_256K1, bip32Path, bip32PathLength,
-                               privateKeyData,
-                               (tmpCtx.publicKeyContext.getChaincode
-                                    ? tmpCtx.publicKeyContext.chainCode
-                                    : NULL));
-    cx_ecfp_init_private_key(CX_CURVE_256K1, privateKeyData, 32, &privateKey);
-    cx_ecfp_generate_pair(CX_CURVE_256K1, &tmpCtx.publicKeyContext.publicKey,
-                          &privateKey, 1);
-    os_memset(&privateKey, 0, sizeof(privateKey));
-    os_memset(privateKeyData, 0, sizeof(privateKeyData));
-    public_key_to_wif(tmpCtx.publicKeyContext.publicKey.W, sizeof(tmpCtx.publicKeyContext.publicKey.W),
-                      tmpCtx.publicKeyContext.address, sizeof(tmpCtx.publicKeyContext.address));
-    if (p1 == P1_NON_CONFIRM)
-    {
-        *tx = get_public_key_and_set_result();
-        THROW(0x9000);
-    }
-    else
+    switch (p1)
     {
+    case P1_MEMO_START:
+        if (hive_memo_parse_path(&memoBatch, workBuffer, dataLength) != dataLength)
+        {
+            hive_memo_end(&memoBatch);
+            THROW(0x6a80);
+        }
+        memoPath[0] = '\0';
+        for (i = 0; i < memoBatch.pathLength; i++)
+        {
+            snprintf((char *)memoPath + strlen((char *)memoPath), sizeof(memoPath) - strlen((char *)memoPath),
+                     (memoBatch.path[i] & 0x80000000) ? "%u'%s" : "%u%s", memoBatch.path[i] & 0x7FFFFFFF,
+                     i + 1 < memoBatch.pathLength ? "/" : "");
+        }
+
 #if defined(TARGET_NANOS)
-        // prepare for a UI based reply
         ux_step = 0;
         ux_step_count = 2;
-        UX_DISPLAY(ui_address_nanos, ui_address_prepro);
+        UX_DISPLAY(ui_memo_nanos, ui_trust_prepro);
 #elif defined(TARGET_NANOX)
-        ux_flow_init(0, ux_display_public_flow, NULL);
+        ux_flow_init(0, ux_memo_flow, NULL);
 #endif
-
+        approvalPending = true;
         *flags |= IO_ASYNCH_REPLY;
+        break;
+
+    case P1_MEMO_RECORDS:
+        *tx = hive_memo_decrypt(&memoBatch, workBuffer, dataLength);
+        // the answers are written over the records
+        os_memmove(G_io_apdu_buffer, workBuffer, *tx);
+        THROW(0x9000);
+
+    case P1_MEMO_END:
+        hive_memo_end(&memoBatch);
+        THROW(0x9000);
+
+    default:
+        THROW(0x6B00);
     }
 }
 
-void handleGetAppConfiguration(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
-                               uint16_t dataLength,
-                               volatile unsigned int *flags,
-                               volatile unsigned int *tx)
+/**
+ * Register or clear transaction templates. Templates only shorten the
+ * signing commands, what they expand to is reviewed as usual, so no
+ * approval is needed.
+*/
+void handleTemplate(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
+                    uint16_t dataLength, volatile unsigned int *flags,
+                    volatile unsigned int *tx)
 {
-    UNUSED(p1);
-    UNUSED(p2);
-    UNUSED(workBuffer);
-    UNUSED(dataLength);
+    uint8_t i;
     UNUSED(flags);
-    G_io_apdu_buffer[0] = (N_storage.dataAllowed ? 0x01 : 0x00);
-    G_io_apdu_buffer[1] = LEDGER_MAJOR_VERSION;
-    G_io_apdu_buffer[2] = LEDGER_MINOR_VERSION;
-    G_io_apdu_buffer[3] = LEDGER_PATCH_VERSION;
-    *tx = 4;
-    THROW(0x9000);
-}
-
-uint32_t sign_hash_and_set_result(void) 
-{
-    // store hash
-    cx_hash(&sha256.header, CX_LAST, tmpCtx.transactionContext.hash, 0, 
-        tmpCtx.transactionContext.hash, sizeof(tmpCtx.transactionContext.hash));
-
-    uint8_t privateKeyData[64];
-    cx_ecfp_private_key_t privateKey;
-    uint32_t tx = 0;
-    uint8_t V[33];
-    uint8_t K[32];
-    int tries = 0;
-
-    os_perso_derive_node_bip32(
-        CX_CURVE_256K1, tmpCtx.transactionContext.bip32Path,
-        tmpCtx.transactionContext.pathLength, privateKeyData, NULL);
-    cx_ecfp_init_private_key(CX_CURVE_256K1, privateKeyData, 32, &privateKey);
-    os_memset(privateKeyData, 0, sizeof(privateKeyData));
 
-    // Loop until a candidate matching the canonical signature is found
-
-    for (;;)
+    if (p2 != 0)
     {
-        if (tries == 0)
-        {
-            rng_rfc6979(G_io_apdu_buffer + 100, tmpCtx.transactionContext.hash, privateKey.d, privateKey.d_len, SECP256K1_N, 32, V, K);
-        }
-        else
+        THROW(0x6B00);
+    }
+    switch (p1)
+    {
+    case P1_TEMPLATE_REGISTER:
+        for (i = 0; i < HIVE_TEMPLATES; i++)
         {
-            rng_rfc6979(G_io_apdu_buffer + 100, tmpCtx.transactionContext.hash, NULL, 0, SECP256K1_N, 32, V, K);
+            if (!hiveTemplates[i].used)
+            {
+                break;
+            }
         }
-        uint32_t infos;
-        tx = cx_ecdsa_sign(&privateKey, CX_NO_CANONICAL | CX_RND_PROVIDED | CX_LAST, CX_SHA256,
-                           tmpCtx.transactionContext.hash, 32, 
-                           G_io_apdu_buffer + 100, 100,
-                           &infos);
-        if ((infos & CX_ECCINFO_PARITY_ODD) != 0)
+        if (i == HIVE_TEMPLATES)
         {
-            G_io_apdu_buffer[100] |= 0x01;
+            PRINTF("No template left\n");
+            THROW(0x6a84);
         }
-        G_io_apdu_buffer[0] = 27 + 4 + (G_io_apdu_buffer[100] & 0x01);
-        ecdsa_der_to_sig(G_io_apdu_buffer + 100, G_io_apdu_buffer + 1);
-        if (check_canonical(G_io_apdu_buffer + 1))
+        if (hive_template_parse(&hiveTemplates[i], workBuffer, dataLength) != dataLength)
         {
-            tx = 1 + 64;
-            break;
+            os_memset(&hiveTemplates[i], 0, sizeof(hiveTemplate_t));
+            THROW(0x6a80);
         }
-        else
+        G_io_apdu_buffer[0] = i;
+        *tx = 1;
+        THROW(0x9000);
+
+    case P1_TEMPLATE_CLEAR:
+        if (txProcessingCtx.templated && (txProcessingCtx.state != TLV_NONE) &&
+            (txProcessingCtx.state != TLV_DONE))
         {
-            tries++;
+            PRINTF("Template in use\n");
+            THROW(0x6985);
         }
-    }
-
-    os_memset(&privateKey, 0, sizeof(privateKey));
+        os_memset(hiveTemplates, 0, sizeof(hiveTemplates));
+        THROW(0x9000);
 
-    return tx;
+    default:
+        THROW(0x6B00);
+    }
 }
 
-void handleSign(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
-                uint16_t dataLength, volatile unsigned int *flags,
-                volatile unsigned int *tx)
+#ifdef HAVE_BENCHMARK
+#define P1_BENCHMARK_GENERIC 0x00
+#define P1_BENCHMARK_INDEXED 0x01
+#define P1_BENCHMARK_SIGN_DERIVED 0x02
+#define P1_BENCHMARK_SIGN_PREPARED 0x03
+
+/**
+ * Sign a zero digest with the key of a path P2 times, what the approval of
+ * a transaction runs, either deriving the key or with the key prepared
+ * during the review.
+*/
+static void benchmark_sign(uint8_t p1, uint8_t p2, uint8_t *workBuffer, uint16_t dataLength)
 {
-    uint32_t i;
-    parserStatus_e txResult;
-    if (p1 == P1_FIRST)
+    cx_ecfp_private_key_t privateKey;
+    uint8_t i;
+
+    if ((dataLength < 1) || (workBuffer[0] < 0x01) || (workBuffer[0] > MAX_BIP32_PATH))
     {
-        tmpCtx.transactionContext.pathLength = workBuffer[0];
-        if ((tmpCtx.transactionContext.pathLength < 0x01) ||
-            (tmpCtx.transactionContext.pathLength > MAX_BIP32_PATH))
-        {
-            PRINTF("Invalid path\n");
-            THROW(0x6a80);
-        }
-        workBuffer++;
-        dataLength--;
-        for (i = 0; i < tmpCtx.transactionContext.pathLength; i++)
+        THROW(0x6a80);
+    }
+    if (dataLength != 1 + workBuffer[0] * 4)
+    {
+        THROW(0x6700);
+    }
+    // any transaction being streamed is dropped
+    abortTx(&txProcessingCtx);
+    initReviewCache(&reviewCache);
+    partialReview = false;
+    clear_prepared_keys();
+
+    tmpCtx.transactionContext.pathCount = 1;
+    tmpCtx.transactionContext.pathLength[0] = workBuffer[0];
+    workBuffer++;
+    for (i = 0; i < tmpCtx.transactionContext.pathLength[0]; i++)
+    {
+        tmpCtx.transactionContext.bip32Path[0][i] =
+            (workBuffer[0] << 24) | (workBuffer[1] << 16) |
+            (workBuffer[2] << 8) | (workBuffer[3]);
+        workBuffer += 4;
+    }
+    os_memset(tmpCtx.transactionContext.hash, 0, sizeof(tmpCtx.transactionContext.hash));
+
+    derive_signing_key(0, &privateKey);
+    for (i = 0; i < p2; i++)
+    {
+        if (p1 == P1_BENCHMARK_SIGN_PREPARED)
         {
-            tmpCtx.transactionContext.bip32Path[i] =
-                (workBuffer[0] << 24) | (workBuffer[1] << 16) |
-                (workBuffer[2] << 8) | (workBuffer[3]);
-            workBuffer += 4;
-            dataLength -= 4;
+            os_memmove(&preparedKeys.keys[0], &privateKey, sizeof(privateKey));
+            preparedKeys.count = 1;
         }
-        initTxContext(&txProcessingCtx, &sha256, &dataSha256, &txContent, N_storage.dataAllowed);
+        sign_hash_and_set_result();
     }
-    else if (p1 != P1_MORE)
+    os_memset(&privateKey, 0, sizeof(privateKey));
+}
+
+/**
+ * Print every page of a serialized transfer P2 times, either with its
+ * regular decoder or through the field index, or time the signature of
+ * an approved transaction, the host times the command.
+*/
+void handleBenchmark(uint8_t p1, uint8_t p2, uint8_t *workBuffer,
+                     uint16_t dataLength, volatile unsigned int *flags,
+                     volatile unsigned int *tx)
+{
+#ifdef HAVE_HIVE_TRANSFER_FAST_PATH
+    transferFields_t fields;
+    actionArgument_t arg;
+    uint8_t argNum;
+#endif
+    uint8_t i;
+    UNUSED(flags);
+    UNUSED(tx);
+
+    if (p2 == 0)
     {
         THROW(0x6B00);
     }
-    if (p2 != 0)
+    if (p1 == P1_BENCHMARK_SIGN_DERIVED || p1 == P1_BENCHMARK_SIGN_PREPARED)
+    {
+        benchmark_sign(p1, p2, workBuffer, dataLength);
+        THROW(0x9000);
+    }
+#ifdef HAVE_HIVE_TRANSFER_FAST_PATH
+    if (p1 != P1_BENCHMARK_GENERIC && p1 != P1_BENCHMARK_INDEXED)
     {
         THROW(0x6B00);
     }
-    if (txProcessingCtx.state == TLV_NONE)
+    if (dataLength == 0 || !isHiveTransfer(workBuffer[0]))
     {
-        PRINTF("Parser not initialized\n");
-        THROW(0x6985);
+        THROW(0x6a80);
     }
-
-    txResult = parseTx(&txProcessingCtx, workBuffer, dataLength);
-    switch (txResult)
+    for (i = 0; i < p2; i++)
     {
-    case STREAM_CONFIRM_PROCESSING:
-        snprintf((char *)actionCounter, sizeof(actionCounter), "%d operations", txProcessingCtx.numOperations);
-#if defined(TARGET_NANOS)
-        ux_step = 0;
-        ux_step_count = 2;
-        UX_DISPLAY(ui_multiple_action_tx_approval_nanos, ui_multiple_action_tx_approval_prepro);
-#elif defined(TARGET_NANOX)
-        ux_flow_init(0, ux_multiple_action_sign_flow, NULL);
+        if (p1 == P1_BENCHMARK_INDEXED)
+        {
+            if (!indexHiveTransfer(workBuffer, dataLength, &fields))
+            {
+                THROW(0x6a80);
+            }
+            for (argNum = 0; argNum < TRANSFER_FIELDS; argNum++)
+            {
+                printHiveTransferField(workBuffer, dataLength, &fields, argNum, &arg);
+            }
+        }
+        else
+        {
+            for (argNum = 0; argNum < TRANSFER_FIELDS; argNum++)
+            {
+#ifdef HAVE_HIVE_OP_TRANSFER
+                if (workBuffer[0] == 2)
+                {
+                    parseHiveTransfer(workBuffer, dataLength, argNum, &arg);
+                    continue;
+                }
 #endif
-
-        *flags |= IO_ASYNCH_REPLY;
-
-        break;
-    case STREAM_ACTION_READY:
-        ux_step = 0;
-        ux_step_count = txContent.argumentCount;
-
-        if (txProcessingCtx.numOperations > 1) {
-            snprintf((char *)confirmLabel, sizeof(confirmLabel), "Action #%d", txProcessingCtx.currentOpIndex);
-        } else {
-            strcpy((char *)confirmLabel, "Transaction");         
+#ifdef HAVE_HIVE_OP_TRANSFER_TO_SAVINGS
+                parseHiveTransferToSavings(workBuffer, dataLength, argNum, &arg);
+#endif
+            }
         }
-
-#if defined(TARGET_NANOS)
-        ux_step_count += 2;
-        UX_DISPLAY(ui_single_action_tx_approval_nanos, ui_single_action_tx_approval_prepro);
-#elif defined(TARGET_NANOX)
-        strcpy((char *)confirm_text1, txProcessingCtx.currentOpIndex == txProcessingCtx.numOperations ? "Sign" : "Accept");
-        strcpy((char *)confirm_text2, txProcessingCtx.currentOpIndex == txProcessingCtx.numOperations ? "transaction" : "and review next");
-        
-        ux_flow_init(0, ux_single_action_sign_flow, NULL);
+    }
+    THROW(0x9000);
+#else
+    UNUSED(i);
+    THROW(0x6B00);
+#endif
+}
 #endif
 
-        *flags |= IO_ASYNCH_REPLY;
-
-        break;
-    case STREAM_FINISHED:
-        *tx = sign_hash_and_set_result();
-        THROW(0x9000);
-    case STREAM_PROCESSING:
-        THROW(0x9000);
-    case STREAM_FAULT:
-        THROW(0x6A80);
-    default:
-        PRINTF("Unexpected parser status\n");
-        THROW(0x6A80);
+/**
+ * While an operation is on screen, or a signing command is held, only
+ * the rest of the transaction is accepted: the other commands would take
+ * over the display and the signing paths. A transaction still streaming
+ * with nothing left to review is dropped by any other command. Nothing is
+ * accepted while another approval is on screen, its data would be replaced.
+*/
+static void check_transaction_in_progress(uint8_t ins, uint8_t p1)
+{
+    if (approvalPending)
+    {
+        PRINTF("Approval pending\n");
+        THROW(0x6985);
+    }
+    if (ins == INS_SIGN && p1 == P1_MORE)
+    {
+        return;
+    }
+    if (txReplyPending || partialReview || pendingOperations(&txProcessingCtx) != 0)
+    {
+        PRINTF("Transaction under review\n");
+        THROW(0x6985);
+    }
+    if (txProcessingCtx.state != TLV_NONE && ins != INS_SIGN)
+    {
+        abortTx(&txProcessingCtx);
+        clear_prepared_keys();
     }
 }
 
@@ -1326,6 +3345,7 @@ void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx)
             {
                 THROW(0x6E00);
             }
+            check_transaction_in_progress(G_io_apdu_buffer[OFFSET_INS], G_io_apdu_buffer[OFFSET_P1]);
 
             switch (G_io_apdu_buffer[OFFSET_INS])
             {
@@ -1343,6 +3363,57 @@ void handleApdu(volatile unsigned int *flags, volatile unsigned int *tx)
                            G_io_apdu_buffer[OFFSET_LC], flags, tx);
                 break;
 
+            case INS_FIND_PUBLIC_KEYS:
+                handleFindPublicKeys(G_io_apdu_buffer[OFFSET_P1],
+                                     G_io_apdu_buffer[OFFSET_P2],
+                                     G_io_apdu_buffer + OFFSET_CDATA,
+                                     G_io_apdu_buffer[OFFSET_LC], flags, tx);
+                break;
+
+            case INS_SIGN_HASH:
+                handleSignHash(G_io_apdu_buffer[OFFSET_P1],
+                               G_io_apdu_buffer[OFFSET_P2],
+                               G_io_apdu_buffer + OFFSET_CDATA,
+                               G_io_apdu_buffer[OFFSET_LC], flags, tx);
+                break;
+
+            case INS_SESSION:
+                handleSession(G_io_apdu_buffer[OFFSET_P1],
+                              G_io_apdu_buffer[OFFSET_P2],
+                              G_io_apdu_buffer + OFFSET_CDATA,
+                              G_io_apdu_buffer[OFFSET_LC], flags, tx);
+                break;
+
+            case INS_ADDRESS_BOOK:
+                handleAddressBook(G_io_apdu_buffer[OFFSET_P1],
+                                  G_io_apdu_buffer[OFFSET_P2],
+                                  G_io_apdu_buffer + OFFSET_CDATA,
+                                  G_io_apdu_buffer[OFFSET_LC], flags, tx);
+                break;
+
+            case INS_DECRYPT_MEMO:
+                handleDecryptMemo(G_io_apdu_buffer[OFFSET_P1],
+                                  G_io_apdu_buffer[OFFSET_P2],
+                                  G_io_apdu_buffer + OFFSET_CDATA,
+                                  G_io_apdu_buffer[OFFSET_LC], flags, tx);
+                break;
+
+            case INS_TEMPLATE:
+                handleTemplate(G_io_apdu_buffer[OFFSET_P1],
+                               G_io_apdu_buffer[OFFSET_P2],
+                               G_io_apdu_buffer + OFFSET_CDATA,
+                               G_io_apdu_buffer[OFFSET_LC], flags, tx);
+                break;
+
+#ifdef HAVE_BENCHMARK
+            case INS_BENCHMARK:
+                handleBenchmark(G_io_apdu_buffer[OFFSET_P1],
+                                G_io_apdu_buffer[OFFSET_P2],
+                                G_io_apdu_buffer + OFFSET_CDATA,
+                                G_io_apdu_buffer[OFFSET_LC], flags, tx);
+                break;
+#endif
+
             case INS_GET_APP_CONFIGURATION:
                 handleGetAppConfiguration(
                     G_io_apdu_buffer[OFFSET_P1], 
@@ -1514,6 +3585,23 @@ unsigned char io_event(unsigned char channel)
             }
 #endif // TARGET_NANOS
         });
+        // format the neighbouring review pages while the user reads,
+        // then derive the signing keys and the keys authority pages are
+        // matched against
+        if (!prefetchReviewPage(&reviewCache, &txProcessingCtx) &&
+            !prepare_signing_key_step() && reviewCache.active &&
+            pendingOperations(&txProcessingCtx) != 0)
+        {
+            hive_keyindex_build_step();
+        }
+        if (hive_session_tick(&hiveSession))
+        {
+            refresh_session_status();
+            if (UX_ALLOWED && !txReplyPending && pendingOperations(&txProcessingCtx) == 0 && !partialReview)
+            {
+                UX_REDISPLAY();
+            }
+        }
         break;
     }
 
@@ -1568,11 +3656,23 @@ __attribute__((section(".boot"))) int main(void)
                 {
                     internalStorage_t storage;
                     storage.dataAllowed = 0x00;
+                    storage.hashSignAllowed = 0x00;
+                    storage.compactReview = 0x00;
                     storage.initialized = 0x01;
                     nvm_write(&N_storage, (void *)&storage,
                               sizeof(internalStorage_t));
+                    hive_address_book_init();
                 }
 
+                // a session, a memo batch or a transaction never outlives an IO reset
+                hive_session_revoke(&hiveSession);
+                hive_memo_end(&memoBatch);
+                clear_prepared_keys();
+                abortTx(&txProcessingCtx);
+                txReplyPending = false;
+                partialReview = false;
+                approvalPending = false;
+
                 USB_power(0);
                 USB_power(1);
 
@@ -0,0 +1,59 @@
+#!/usr/bin/env python
+"""
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+"""
+
+from ledgerblue.comm import getDongle
+import argparse
+
+parser = argparse.ArgumentParser()
+parser.add_argument('--add', help="Account names to trust", nargs='*', default=[])
+parser.add_argument('--remove', help="Account names to remove", nargs='*', default=[])
+parser.add_argument('--clear', help="Clear the address book", action='store_true')
+args = parser.parse_args()
+
+
+def pack_names(names):
+    return "".join(chr(len(name)) + name for name in names)
+
+dongle = getDongle(True)
+
+if args.clear:
+    dongle.exchange(bytes("D4100300".decode('hex') + chr(0)))
+if args.remove:
+    data = pack_names(args.remove)
+    dongle.exchange(bytes("D4100100".decode('hex') + chr(len(data)) + data))
+if args.add:
+    # the device asks for approval
+    data = pack_names(args.add)
+    dongle.exchange(bytes("D4100000".decode('hex') + chr(len(data)) + data))
+
+names = []
+while True:
+    result = dongle.exchange(bytes("D41002".decode('hex') + chr(len(names)) + chr(0)))
+    count = result[0]
+    offset = 1
+    while offset < len(result):
+        names.append(str(result[offset + 1:offset + 1 + result[offset]]))
+        offset += 1 + result[offset]
+    if len(names) >= count or offset == 1:
+        break
+
+print("%d trusted recipients" % len(names))
+for name in names:
+    print(name)
@@ -0,0 +1,80 @@
+#!/usr/bin/env python
+"""
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+"""
+
+import json
+import struct
+import time
+from hiveBase import Transaction
+from ledgerblue.comm import getDongle
+import argparse
+
+def parse_bip32_path(path):
+    if len(path) == 0:
+        return ""
+    result = ""
+    elements = path.split('/')
+    for pathElement in elements:
+        element = pathElement.split('\'')
+        if len(element) == 1:
+            result = result + struct.pack(">I", int(element[0]))
+        else:
+            result = result + struct.pack(">I", 0x80000000 | int(element[0]))
+    return result
+
+# needs an application built with make BENCHMARK=1
+parser = argparse.ArgumentParser()
+parser.add_argument('--file', help="Transfer transaction in JSON format")
+parser.add_argument('--iterations', help="Decodings per command (max 255)", type=int, default=100)
+parser.add_argument('--commands', help="Commands per decoding path", type=int, default=20)
+parser.add_argument('--path', help="BIP 32 path timed for the approval signature")
+parser.add_argument('--signatures', help="Signatures per command (max 255)", type=int, default=5)
+args = parser.parse_args()
+
+if args.path is None:
+    args.path = "48'/13'/0'/0'/0'"
+if args.file is None:
+    args.file = 'txs/tx-transfer.json'
+
+with file(args.file) as f:
+    obj = json.load(f)
+    operation = Transaction.parse_transfer(obj['operations'][0][1])
+
+dongle = getDongle(False)
+timings = {}
+for name, p1 in [("generic", "00"), ("indexed", "01")]:
+    apdu = ("D4F0" + p1).decode('hex') + chr(args.iterations) + chr(len(operation)) + operation
+    start = time.time()
+    for i in range(args.commands):
+        dongle.exchange(bytes(apdu))
+    timings[name] = (time.time() - start) / (args.commands * args.iterations)
+    print("%s: %.3f ms per transfer review" % (name, timings[name] * 1000))
+
+print("speedup: %.2fx" % (timings["generic"] / timings["indexed"]))
+
+# time between the approval and the signed answer
+donglePath = parse_bip32_path(args.path)
+pathData = chr(len(donglePath) / 4) + donglePath
+for name, p1 in [("derived", "02"), ("prepared", "03")]:
+    apdu = ("D4F0" + p1).decode('hex') + chr(args.signatures) + chr(len(pathData)) + pathData
+    start = time.time()
+    for i in range(args.commands):
+        dongle.exchange(bytes(apdu))
+    timings[name] = (time.time() - start) / (args.commands * args.signatures)
+    print("%s key: %.1f ms from approval to signature" % (name, timings[name] * 1000))
@@ -0,0 +1,108 @@
+#!/usr/bin/env python
+"""
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+"""
+
+import struct
+from ledgerblue.comm import getDongle
+import argparse
+
+B58_ALPHABET = '123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz'
+
+def parse_bip32_path(path):
+    if len(path) == 0:
+        return ""
+    result = ""
+    elements = path.split('/')
+    for pathElement in elements:
+        element = pathElement.split('\'')
+        if len(element) == 1:
+            result = result + struct.pack(">I", int(element[0]))
+        else:
+            result = result + struct.pack(">I", 0x80000000 | int(element[0]))
+    return result
+
+
+def b58decode(value):
+    number = 0
+    for c in value:
+        number = number * 58 + B58_ALPHABET.index(c)
+    result = ""
+    while number > 0:
+        result = chr(number % 256) + result
+        number //= 256
+    return chr(0) * (len(value) - len(value.lstrip('1'))) + result
+
+
+def read_varint(data, offset):
+    value = 0
+    shift = 0
+    while True:
+        b = ord(data[offset])
+        offset += 1
+        value |= (b & 0x7f) << shift
+        shift += 7
+        if not b & 0x80:
+            return value, offset
+
+
+def memo_record(memo, ownKey):
+    # serialized memo: from, to, nonce, check, encrypted
+    data = b58decode(memo[1:])
+    sender = data[0:33]
+    recipient = data[33:66]
+    length, offset = read_varint(data, 74)
+    other = recipient if sender == ownKey else sender
+    return other + data[66:74] + chr(length) + data[offset:offset + length]
+
+
+parser = argparse.ArgumentParser()
+parser.add_argument('--path', help="BIP 32 path of the memo key")
+parser.add_argument('--memo', help="Encrypted memos, starting with #", nargs='+', required=True)
+args = parser.parse_args()
+
+if args.path is None:
+    args.path = "48'/13'/3'/0'/0'"
+
+donglePath = parse_bip32_path(args.path)
+pathData = chr(len(donglePath) / 4) + donglePath
+dongle = getDongle(True)
+
+result = dongle.exchange(bytes("D4020000".decode('hex') + chr(len(pathData)) + pathData))
+point = str(result[1:66])
+ownKey = chr(2 + (ord(point[64]) & 1)) + point[1:33]
+
+# the device asks for approval once for the whole batch
+dongle.exchange(bytes("D4120000".decode('hex') + chr(len(pathData)) + pathData))
+
+records = [memo_record(memo, ownKey) for memo in args.memo]
+while records:
+    data = ""
+    while records and len(data) + len(records[0]) <= 250:
+        data += records.pop(0)
+    result = dongle.exchange(bytes("D4128000".decode('hex') + chr(len(data)) + data))
+    offset = 0
+    while offset < len(result):
+        if result[offset] == 0xFF:
+            print("(unreadable memo)")
+            offset += 1
+            continue
+        print(str(result[offset + 1:offset + 1 + result[offset]]))
+        offset += 1 + result[offset]
+
+dongle.exchange(bytes("D4120100".decode('hex') + chr(0)))
@@ -0,0 +1,77 @@
+#!/usr/bin/env python
+"""
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+"""
+from ledgerblue.comm import getDongle
+import argparse
+import struct
+from base58 import b58decode
+
+
+def parse_bip32_path(path):
+    if len(path) == 0:
+        return b""
+    result = b""
+    elements = path.split('/')
+    for pathElement in elements:
+        element = pathElement.split('\'')
+        if len(element) == 1:
+            result = result + struct.pack(">I", int(element[0]))
+        else:
+            result = result + struct.pack(">I", 0x80000000 | int(element[0]))
+    return result
+
+
+def wif_to_compressed(key):
+    if key.startswith("STM"):
+        key = key[3:]
+    return b58decode(key)[:33]
+
+
+parser = argparse.ArgumentParser()
+parser.add_argument('--path', help="BIP 32 path template, last index is the first one scanned")
+parser.add_argument('--count', help="Number of indices to scan", type=int, default=100)
+parser.add_argument('keys', nargs='+', help="STM public keys to look for (max 4)")
+args = parser.parse_args()
+
+if args.path is None:
+    args.path = "48'/13'/0'/0'/0'"
+
+targets = [wif_to_compressed(key) for key in args.keys]
+donglePath = parse_bip32_path(args.path)
+left = args.count
+
+dongle = getDongle(True)
+# the device scans at most 20 indices per command
+while targets and left > 0:
+    batch = min(left, 20)
+    data = bytes([len(targets)]) + b"".join(targets) + bytes([len(donglePath) // 4]) + donglePath + struct.pack(">H", batch)
+    apdu = bytes.fromhex('D4080000') + bytes([len(data)]) + data
+    result = dongle.exchange(bytes(apdu))
+
+    offset = 1
+    for i in range(result[0]):
+        key = result[offset: offset + 33]
+        index = struct.unpack(">I", result[offset + 33: offset + 37])[0]
+        hardened = "'" if index & 0x80000000 else ""
+        print("Found " + key.hex() + " at index " + str(index & 0x7FFFFFFF) + hardened)
+        targets = [target for target in targets if target != key]
+        offset += 37
+    nextIndex = result[offset: offset + 4]
+    left -= struct.unpack(">I", nextIndex)[0] - struct.unpack(">I", donglePath[-4:])[0]
+    donglePath = donglePath[:-4] + nextIndex
@@ -0,0 +1,92 @@
+#!/usr/bin/env python
+"""
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+"""
+from ledgerblue.comm import getDongle
+import argparse
+import struct
+import hashlib
+import hmac
+from base58 import b58encode
+from ecdsa import SECP256k1, VerifyingKey
+from ecdsa.ellipticcurve import Point
+
+
+def parse_bip32_path(path):
+    if len(path) == 0:
+        return b""
+    result = b""
+    elements = path.split('/')
+    for pathElement in elements:
+        element = pathElement.split('\'')
+        if len(element) == 1:
+            result = result + struct.pack(">I", int(element[0]))
+        else:
+            result = result + struct.pack(">I", 0x80000000 | int(element[0]))
+    return result
+
+
+def compress(point):
+    return bytes([0x03 if point.y() & 1 else 0x02]) + point.x().to_bytes(32, 'big')
+
+
+def derive_child(key, chain_code, index):
+    digest = hmac.new(chain_code, key + struct.pack(">I", index), hashlib.sha512).digest()
+    parent = VerifyingKey.from_string(key, curve=SECP256k1).pubkey.point
+    child = SECP256k1.generator * int.from_bytes(digest[:32], 'big') + parent
+    return compress(child)
+
+
+def to_wif(key):
+    ripemd = hashlib.new('ripemd160')
+    ripemd.update(key)
+    return "STM" + b58encode(key + ripemd.digest()[:4]).decode()
+
+
+def to_xpub(depth, fingerprint, child, chain_code, key):
+    payload = bytes.fromhex('0488B21E') + bytes([depth]) + fingerprint + struct.pack(">I", child) + chain_code + key
+    check = hashlib.sha256(hashlib.sha256(payload).digest()).digest()[:4]
+    return b58encode(payload + check).decode()
+
+
+parser = argparse.ArgumentParser()
+parser.add_argument('--path', help="BIP 32 path of the parent key")
+parser.add_argument('--count', help="Number of non-hardened children to derive", type=int, default=5)
+args = parser.parse_args()
+
+if args.path is None:
+    args.path = "48'/13'/0'/0'"
+
+donglePath = parse_bip32_path(args.path)
+apdu = bytes.fromhex('D4020002') + bytes([len(donglePath) + 1, len(donglePath) // 4]) + donglePath
+
+dongle = getDongle(True)
+result = dongle.exchange(bytes(apdu))
+
+public_key = result[1: 1 + result[0]]
+offset = 1 + result[0]
+offset += 1 + result[offset]
+chain_code = result[offset: offset + 32]
+depth = result[offset + 32]
+fingerprint = result[offset + 33: offset + 37]
+child = struct.unpack(">I", result[offset + 37: offset + 41])[0]
+
+key = bytes([0x03 if public_key[64] & 0x01 else 0x02]) + public_key[1:33]
+print("xpub: " + to_xpub(depth, fingerprint, child, chain_code, key))
+for index in range(args.count):
+    print(args.path + "/" + str(index) + " " + to_wif(derive_child(key, chain_code, index)))
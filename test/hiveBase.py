@@ -227,39 +227,36 @@ class Transaction:
         return unhexlify(parameters)
 
     @staticmethod
-    def parse_account_create(data):
-        parameters = hexlify(Transaction.pack_fc_uint(Operation.types()["account_create"]))
-        parameters += hexlify(Transaction.parse_asset(data["amount"]))
-        parameters += hexlify(Transaction.pack_fc_uint(len(data['creator'])) + data['creator'])
-        parameters += hexlify(Transaction.pack_fc_uint(len(data['new_account_name'])) + data['new_account_name'])
-        parameters += hexlify(struct.pack("<L", data['owner']['weight_threshold']))
-        parameters += hexlify(struct.pack("<b", len(data['owner']['account_auths'])))
-        for item in data['owner']['account_auths']:
+    def parse_authority(data):
+        parameters = hexlify(struct.pack("<L", data['weight_threshold']))
+        parameters += hexlify(Transaction.pack_fc_uint(len(data['account_auths'])))
+        for item in data['account_auths']:
             parameters += hexlify(Transaction.pack_fc_uint(len(item[0])) + item[0])
             parameters += hexlify(struct.pack("<H", item[1]))
-        parameters += hexlify(struct.pack("<b", len(data['owner']['key_auths'])))
-        for item in data['owner']['key_auths']:
-            parameters += hexlify(Transaction.parse_public_key(item[0]))
-            parameters += hexlify(struct.pack("<H", item[1]))
-        parameters += hexlify(struct.pack("<L", data['active']['weight_threshold']))
-        parameters += hexlify(struct.pack("<b", len(data['active']['account_auths'])))
-        for item in data['active']['account_auths']:
-            parameters += hexlify(Transaction.pack_fc_uint(len(item[0])) + item[0])
-            parameters += hexlify(struct.pack("<H", item[1]))
-        parameters += hexlify(struct.pack("<b", len(data['active']['key_auths'])))
-        for item in data['active']['key_auths']:
-            parameters += hexlify(Transaction.parse_public_key(item[0]))
-            parameters += hexlify(struct.pack("<H", item[1]))
-        parameters += hexlify(struct.pack("<L", data['posting']['weight_threshold']))
-        parameters += hexlify(struct.pack("<b", len(data['posting']['account_auths'])))
-        for item in data['posting']['account_auths']:
-            parameters += hexlify(Transaction.pack_fc_uint(len(item[0])) + item[0])
-            parameters += hexlify(struct.pack("<H", item[1]))
-        parameters += hexlify(struct.pack("<b", len(data['posting']['key_auths'])))
-        for item in data['posting']['key_auths']:
+        parameters += hexlify(Transaction.pack_fc_uint(len(data['key_auths'])))
+        for item in data['key_auths']:
             parameters += hexlify(Transaction.parse_public_key(item[0]))
             parameters += hexlify(struct.pack("<H", item[1]))
+
+        return unhexlify(parameters)
+
+    @staticmethod
+    def parse_optional_authority(data):
+        if data is None:
+            return unhexlify("00")
+        return unhexlify("01") + Transaction.parse_authority(data)
+
+    @staticmethod
+    def parse_account_create(data):
+        parameters = hexlify(Transaction.pack_fc_uint(Operation.types()["account_create"]))
+        parameters += hexlify(Transaction.parse_asset(data["fee"]))
+        parameters += hexlify(Transaction.pack_fc_uint(len(data['creator'])) + data['creator'])
+        parameters += hexlify(Transaction.pack_fc_uint(len(data['new_account_name'])) + data['new_account_name'])
+        parameters += hexlify(Transaction.parse_authority(data['owner']))
+        parameters += hexlify(Transaction.parse_authority(data['active']))
+        parameters += hexlify(Transaction.parse_authority(data['posting']))
         parameters += hexlify(Transaction.parse_public_key(data["memo_key"]))
+        parameters += hexlify(Transaction.pack_fc_uint(len(data['json_metadata'])) + data['json_metadata'])
 
         return unhexlify(parameters)
 
@@ -267,34 +264,11 @@ class Transaction:
     def parse_account_update(data):
         parameters = hexlify(Transaction.pack_fc_uint(Operation.types()["account_update"]))
         parameters += hexlify(Transaction.pack_fc_uint(len(data['account'])) + data['account'])
-        parameters += hexlify(struct.pack("<L", data['owner']['weight_threshold']))
-        parameters += hexlify(struct.pack("<b", len(data['owner']['account_auths'])))
-        for item in data['owner']['account_auths']:
-            parameters += hexlify(Transaction.pack_fc_uint(len(item[0])) + item[0])
-            parameters += hexlify(struct.pack("<H", item[1]))
-        parameters += hexlify(struct.pack("<b", len(data['owner']['key_auths'])))
-        for item in data['owner']['key_auths']:
-            parameters += hexlify(Transaction.parse_public_key(item[0]))
-            parameters += hexlify(struct.pack("<H", item[1]))
-        parameters += hexlify(struct.pack("<L", data['active']['weight_threshold']))
-        parameters += hexlify(struct.pack("<b", len(data['active']['account_auths'])))
-        for item in data['active']['account_auths']:
-            parameters += hexlify(Transaction.pack_fc_uint(len(item[0])) + item[0])
-            parameters += hexlify(struct.pack("<H", item[1]))
-        parameters += hexlify(struct.pack("<b", len(data['active']['key_auths'])))
-        for item in data['active']['key_auths']:
-            parameters += hexlify(Transaction.parse_public_key(item[0]))
-            parameters += hexlify(struct.pack("<H", item[1]))
-        parameters += hexlify(struct.pack("<L", data['posting']['weight_threshold']))
-        parameters += hexlify(struct.pack("<b", len(data['posting']['account_auths'])))
-        for item in data['posting']['account_auths']:
-            parameters += hexlify(Transaction.pack_fc_uint(len(item[0])) + item[0])
-            parameters += hexlify(struct.pack("<H", item[1]))
-        parameters += hexlify(struct.pack("<b", len(data['posting']['key_auths'])))
-        for item in data['posting']['key_auths']:
-            parameters += hexlify(Transaction.parse_public_key(item[0]))
-            parameters += hexlify(struct.pack("<H", item[1]))
+        parameters += hexlify(Transaction.parse_optional_authority(data.get('owner')))
+        parameters += hexlify(Transaction.parse_optional_authority(data.get('active')))
+        parameters += hexlify(Transaction.parse_optional_authority(data.get('posting')))
         parameters += hexlify(Transaction.parse_public_key(data["memo_key"]))
+        parameters += hexlify(Transaction.pack_fc_uint(len(data['json_metadata'])) + data['json_metadata'])
 
         return unhexlify(parameters)
 
@@ -363,14 +337,14 @@ class Transaction:
         parameters += hexlify(struct.pack("<h", int(data["percent_steem_dollars"])))
         parameters += "01" if data['allow_votes'] else "00"
         parameters += "01" if data['allow_curation_rewards'] else "00"
-        parameters += hexlify(struct.pack("<h", len(data.get("extensions", []))))
-        for item in data['extensions']:
+        parameters += hexlify(Transaction.pack_fc_uint(len(data.get("extensions", []))))
+        for item in data.get('extensions', []):
             if item[0] != 0:
                 raise "extension type not implemented"
             parameters += hexlify(Transaction.pack_fc_uint(len(item[1]['beneficiaries'])))
             for beneficiary in item[1]['beneficiaries']:
                 parameters += hexlify(Transaction.pack_fc_uint(len(beneficiary['account'])) + beneficiary['account'])
-                parameters += hexlify(struct.pack("<h", int(beneficiary["weight"])))
+                parameters += hexlify(struct.pack("<H", int(beneficiary["weight"])))
 
         return unhexlify(parameters)
 
@@ -389,6 +363,7 @@ class Transaction:
         parameters = hexlify(Transaction.pack_fc_uint(Operation.types()["claim_account"]))
         parameters += hexlify(Transaction.pack_fc_uint(len(data['creator'])) + data['creator'])
         parameters += hexlify(Transaction.parse_asset(data["fee"]))
+        parameters += hexlify(Transaction.pack_fc_uint(len(data.get('extensions', []))))
 
         return unhexlify(parameters)
 
@@ -397,35 +372,13 @@ class Transaction:
         parameters = hexlify(Transaction.pack_fc_uint(Operation.types()["create_claimed_account"]))
         parameters += hexlify(Transaction.pack_fc_uint(len(data['creator'])) + data['creator'])
         parameters += hexlify(Transaction.pack_fc_uint(len(data['new_account_name'])) + data['new_account_name'])
-        parameters += hexlify(struct.pack("<L", data['owner']['weight_threshold']))
-        parameters += hexlify(struct.pack("<b", len(data['owner']['account_auths'])))
-        for item in data['owner']['account_auths']:
-            parameters += hexlify(Transaction.pack_fc_uint(len(item[0])) + item[0])
-            parameters += hexlify(struct.pack("<H", item[1]))
-        parameters += hexlify(struct.pack("<b", len(data['owner']['key_auths'])))
-        for item in data['owner']['key_auths']:
-            parameters += hexlify(Transaction.parse_public_key(item[0]))
-            parameters += hexlify(struct.pack("<H", item[1]))
-        parameters += hexlify(struct.pack("<L", data['active']['weight_threshold']))
-        parameters += hexlify(struct.pack("<b", len(data['active']['account_auths'])))
-        for item in data['active']['account_auths']:
-            parameters += hexlify(Transaction.pack_fc_uint(len(item[0])) + item[0])
-            parameters += hexlify(struct.pack("<H", item[1]))
-        parameters += hexlify(struct.pack("<b", len(data['active']['key_auths'])))
-        for item in data['active']['key_auths']:
-            parameters += hexlify(Transaction.parse_public_key(item[0]))
-            parameters += hexlify(struct.pack("<H", item[1]))
-        parameters += hexlify(struct.pack("<L", data['posting']['weight_threshold']))
-        parameters += hexlify(struct.pack("<b", len(data['posting']['account_auths'])))
-        for item in data['posting']['account_auths']:
-            parameters += hexlify(Transaction.pack_fc_uint(len(item[0])) + item[0])
-            parameters += hexlify(struct.pack("<H", item[1]))
-        parameters += hexlify(struct.pack("<b", len(data['posting']['key_auths'])))
-        for item in data['posting']['key_auths']:
-            parameters += hexlify(Transaction.parse_public_key(item[0]))
-            parameters += hexlify(struct.pack("<H", item[1]))
+        parameters += hexlify(Transaction.parse_authority(data['owner']))
+        parameters += hexlify(Transaction.parse_authority(data['active']))
+        parameters += hexlify(Transaction.parse_authority(data['posting']))
         parameters += hexlify(Transaction.parse_public_key(data["memo_key"]))
-        parameters += hexlify(struct.pack("<L", len(data.get('extensions', []))))
+        parameters += hexlify(Transaction.pack_fc_uint(len(data['json_metadata'])) + data['json_metadata'])
+        parameters += hexlify(Transaction.pack_fc_uint(len(data.get('extensions', []))))
+
         return unhexlify(parameters)
 
     @staticmethod
@@ -442,7 +395,7 @@ class Transaction:
         for item in data['new_owner_authority']['key_auths']:
             parameters += hexlify(Transaction.parse_public_key(item[0]))
             parameters += hexlify(struct.pack("<H", item[1]))
-        parameters += hexlify(struct.pack("<L", len(data.get('extensions', []))))
+        parameters += hexlify(Transaction.pack_fc_uint(len(data.get('extensions', []))))
         return unhexlify(parameters)
 
     @staticmethod
@@ -467,7 +420,7 @@ class Transaction:
         for item in data['recent_owner_authority']['key_auths']:
             parameters += hexlify(Transaction.parse_public_key(item[0]))
             parameters += hexlify(struct.pack("<H", item[1]))
-        parameters += hexlify(struct.pack("<L", len(data.get('extensions', []))))
+        parameters += hexlify(Transaction.pack_fc_uint(len(data.get('extensions', []))))
         return unhexlify(parameters)
 
     @staticmethod
@@ -475,7 +428,7 @@ class Transaction:
         parameters = hexlify(Transaction.pack_fc_uint(Operation.types()["change_recovery_account"]))
         parameters += hexlify(Transaction.pack_fc_uint(len(data['account_to_recover'])) + data['account_to_recover'])
         parameters += hexlify(Transaction.pack_fc_uint(len(data['new_recovery_account'])) + data['new_recovery_account'])
-        parameters += hexlify(struct.pack("<L", len(data.get('extensions', []))))
+        parameters += hexlify(Transaction.pack_fc_uint(len(data.get('extensions', []))))
         return unhexlify(parameters)
 
     @staticmethod
@@ -577,7 +530,7 @@ class Transaction:
         parameters += hexlify(Transaction.parse_asset(data["daily_pay"]))
         parameters += hexlify(Transaction.pack_fc_uint(len(data['subject'])) + data['subject'])
         parameters += hexlify(Transaction.pack_fc_uint(len(data['permlink'])) + data['permlink'])
-        parameters += hexlify(struct.pack("<L", len(data.get('extensions', []))))
+        parameters += hexlify(Transaction.pack_fc_uint(len(data.get('extensions', []))))
 
         return unhexlify(parameters)
 
@@ -589,7 +542,7 @@ class Transaction:
         for item in data["proposal_ids"]:
             parameters += hexlify(struct.pack("<q", item))
         parameters += "01" if data['approve'] else "00"
-        parameters += hexlify(struct.pack("<L", len(data.get('extensions', []))))
+        parameters += hexlify(Transaction.pack_fc_uint(len(data.get('extensions', []))))
 
         return unhexlify(parameters)
 
@@ -600,7 +553,7 @@ class Transaction:
         parameters += hexlify(Transaction.pack_fc_uint(len(data['proposal_ids'])))
         for item in data["proposal_ids"]:
             parameters += hexlify(struct.pack("<q", item))
-        parameters += hexlify(struct.pack("<L", len(data.get('extensions', []))))
+        parameters += hexlify(Transaction.pack_fc_uint(len(data.get('extensions', []))))
 
         return unhexlify(parameters)
 
@@ -714,8 +667,7 @@ class Transaction:
 
         return tx
 
-    def encode(self):
-        encoder = Encoder()
+    def digest(self):
         sha = hashlib.sha256()
 
         sha.update(self.chain_id)
@@ -727,7 +679,12 @@ class Transaction:
             sha.update(operation.data)
         sha.update(self.extensions_size)
 
-        print 'Signing digest ' + sha.hexdigest()
+        return sha.digest()
+
+    def encode(self):
+        encoder = Encoder()
+
+        print 'Signing digest ' + hexlify(self.digest())
 
         encoder.start()
         encoder.write(self.chain_id, Numbers.OctetString)
@@ -0,0 +1,85 @@
+#!/usr/bin/env python
+"""
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+"""
+
+import binascii
+import json
+import struct
+from hiveBase import Transaction
+from ledgerblue.comm import getDongle
+import argparse
+
+def parse_bip32_path(path):
+    if len(path) == 0:
+        return ""
+    result = ""
+    elements = path.split('/')
+    for pathElement in elements:
+        element = pathElement.split('\'')
+        if len(element) == 1:
+            result = result + struct.pack(">I", int(element[0]))
+        else:
+            result = result + struct.pack(">I", 0x80000000 | int(element[0]))
+    return result
+
+
+OPERATION_TYPES = {"vote": 0, "custom_json": 18}
+
+parser = argparse.ArgumentParser()
+parser.add_argument('--path', help="Session key BIP 32 path")
+parser.add_argument('--accounts', help="Comma separated session accounts, the publisher of a witness session")
+parser.add_argument('--ops', help="Comma separated operation types (vote, custom_json)")
+parser.add_argument('--signatures', help="Maximum number of signatures", type=int, default=100)
+parser.add_argument('--minutes', help="Session duration in minutes", type=int, default=60)
+parser.add_argument('--witness', help="Start a witness session for price feeds", action='store_true')
+parser.add_argument('--band', help="Witness price band in basis points", type=int, default=500)
+parser.add_argument('--end', help="End the current session", action='store_true')
+parser.add_argument('--status', help="Print the current session status", action='store_true')
+args = parser.parse_args()
+
+if args.path is None:
+    args.path = "48'/13'/1'/0'/0'" if args.witness else "48'/13'/4'/0'/0'"
+if args.accounts is None:
+    args.accounts = "netuoso"
+if args.ops is None:
+    args.ops = "vote,custom_json"
+
+dongle = getDongle(True)
+
+if args.end:
+    dongle.exchange(bytes("D40C010000".decode('hex')))
+elif args.status:
+    result = dongle.exchange(bytes("D40C020000".decode('hex')))
+    active, signatures, minutes, kind = struct.unpack(">BHHB", bytes(result))
+    print("%s session active: %d, signatures left: %d, minutes left: %d" %
+          ("witness" if kind else "posting", active, signatures, minutes))
+else:
+    donglePath = parse_bip32_path(args.path)
+    data = chr(len(donglePath) / 4) + donglePath
+    data += struct.pack(">HH", args.signatures, args.minutes)
+    if args.witness:
+        data += struct.pack(">H", args.band)
+    else:
+        ops = args.ops.split(',')
+        data += chr(len(ops)) + "".join(chr(OPERATION_TYPES[op]) for op in ops)
+    accounts = args.accounts.split(',')
+    data += chr(len(accounts)) + "".join(chr(len(account)) + account for account in accounts)
+    apdu = ("D40C0001" if args.witness else "D40C0000").decode('hex') + chr(len(data)) + data
+    dongle.exchange(bytes(apdu))
+    print("Session started")
@@ -0,0 +1,85 @@
+#!/usr/bin/env python
+"""
+/*******************************************************************************
+*   Andrew (netuoso) Chaney
+*   (c) 2020 Andrew Chaney
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+"""
+
+import binascii
+import json
+import struct
+from hiveBase import Transaction
+from ledgerblue.comm import getDongle
+import argparse
+
+def parse_bip32_path(path):
+    if len(path) == 0:
+        return ""
+    result = ""
+    elements = path.split('/')
+    for pathElement in elements:
+        element = pathElement.split('\'')
+        if len(element) == 1:
+            result = result + struct.pack(">I", int(element[0]))
+        else:
+            result = result + struct.pack(">I", 0x80000000 | int(element[0]))
+    return result
+
+
+def pack_string(value):
+    return Transaction.pack_fc_uint(len(value)) + value
+
+
+parser = argparse.ArgumentParser()
+parser.add_argument('--path', help="BIP 32 path to sign with")
+parser.add_argument('--file', help="Transfer transaction in JSON format, its sender is the fixed field")
+parser.add_argument('--clear', help="Clear the registered templates", action='store_true')
+args = parser.parse_args()
+
+if args.path is None:
+    args.path = "48'/13'/0'/0'/0'"
+
+if args.file is None:
+    args.file = 'txs/tx-transfer.json'
+
+dongle = getDongle(True)
+
+if args.clear:
+    dongle.exchange(bytes("D40E010000".decode('hex')))
+    exit()
+
+with file(args.file) as f:
+    obj = json.load(f)
+    tx = Transaction.parse(obj)
+    transfer = obj['operations'][0][1]
+
+    # transfer from a fixed account, the recipient, amount and memo vary
+    data = tx.chain_id + chr(2) + chr(4)
+    data += chr(len(pack_string(transfer['from']))) + pack_string(transfer['from'])
+    data += chr(0) * 3
+    result = dongle.exchange(bytes("D40E0000".decode('hex') + chr(len(data)) + data))
+    templateId = result[0]
+    print("Template %d registered" % templateId)
+
+    fields = [pack_string(transfer['to']), Transaction.parse_asset(transfer['amount']), pack_string(transfer['memo'])]
+    donglePath = parse_bip32_path(args.path)
+    data = chr(len(donglePath) / 4) + donglePath + chr(templateId)
+    data += tx.ref_block_num + tx.ref_block_prefix + tx.expiration
+    data += "".join(chr(len(field)) + field for field in fields)
+    print("Template data %d bytes, transaction %d bytes" % (len(data), len(tx.encode())))
+    result = dongle.exchange(bytes("D4040004".decode('hex') + chr(len(data)) + data))
+
+print(binascii.hexlify(result))
@@ -39,9 +39,63 @@ def parse_bip32_path(path):
     return result
 
 
+LZ_DICTIONARY = bytearray.fromhex(
+    "0000000420beeab0de0402040403535445454d00000353424400000000065645"
+    "53545300005b22666f6c6c6f77222c7b22666f6c6c6f776572223a22222c2266"
+    "6f6c6c6f77696e67223a22222c2277686174223a5b22626c6f67225d7d5d5b22"
+    "7265626c6f67222c7b226163636f756e74223a22222c22617574686f72223a22"
+    "222c227065726d6c696e6b223a227b22636f6e74726163744e616d65223a2274"
+    "6f6b656e73222c22636f6e7472616374416374696f6e223a227472616e736665"
+    "72222c22636f6e74726163745061796c6f6164223a7b2273796d626f6c223a22"
+    "222c22746f223a22222c227175616e74697479223a22222c226d656d6f223a22"
+)
+
+
+def lz_compress(data):
+    """Compressed framing: literal runs and (length, distance) matches
+    over a 256 bytes window seeded with LZ_DICTIONARY."""
+    data = bytearray(data)
+    history = bytearray(LZ_DICTIONARY)
+    out = bytearray()
+    literals = bytearray()
+    i = 0
+    while i < len(data):
+        best_length, best_distance = 0, 0
+        for distance in range(1, 257):
+            start = len(history) - distance
+            length = 0
+            while length < 130 and i + length < len(data):
+                source = start + length
+                byte = history[source] if source < len(history) else data[i + source - len(history)]
+                if byte != data[i + length]:
+                    break
+                length += 1
+            if length > best_length:
+                best_length, best_distance = length, distance
+        if best_length >= 3:
+            while literals:
+                out.append(len(literals[:128]) - 1)
+                out += literals[:128]
+                literals = literals[128:]
+            out.append(0x80 | (best_length - 3))
+            out.append(best_distance - 1)
+            step = best_length
+        else:
+            literals.append(data[i])
+            step = 1
+        history += data[i:i + step]
+        i += step
+    while literals:
+        out.append(len(literals[:128]) - 1)
+        out += literals[:128]
+        literals = literals[128:]
+    return bytes(out)
+
+
 parser = argparse.ArgumentParser()
-parser.add_argument('--path', help="BIP 32 path to retrieve")
+parser.add_argument('--path', help="BIP 32 path to retrieve, comma separated to co-sign with several paths")
 parser.add_argument('--file', help="Transaction in JSON format")
+parser.add_argument('--compress', action='store_true', help="Send the transaction compressed")
 args = parser.parse_args()
 
 if args.path is None:
@@ -50,30 +104,48 @@ if args.path is None:
 if args.file is None:
     args.file = 'txs/tx-transfer.json'
 
-donglePath = parse_bip32_path(args.path)
-pathSize = len(donglePath) / 4
+paths = args.path.split(',')
+if len(paths) == 1:
+    donglePath = parse_bip32_path(paths[0])
+    pathHeader = chr(len(donglePath) / 4) + donglePath
+    p2 = "00"
+else:
+    pathHeader = chr(len(paths))
+    for path in paths:
+        donglePath = parse_bip32_path(path)
+        pathHeader += chr(len(donglePath) / 4) + donglePath
+    p2 = "01"
+
+if args.compress:
+    p2 = "%02x" % (int(p2, 16) | 0x02)
 
 with file(args.file) as f:
     obj = json.load(f)
     tx = Transaction.parse(obj)
     tx_raw = tx.encode()
     signData = tx_raw
+    if args.compress:
+        signData = lz_compress(tx_raw)
+        print("COMPRESSED %d -> %d" % (len(tx_raw), len(signData)))
 
     dongle = getDongle(True)
     offset = 0
     first = True
     singSize = len(signData)
     while offset != singSize:
-        if singSize - offset > 200:
-            chunk = signData[offset: offset + 200]
+        chunkSize = 200
+        if first:
+            chunkSize = min(chunkSize, 255 - len(pathHeader))
+        if singSize - offset > chunkSize:
+            chunk = signData[offset: offset + chunkSize]
         else:
             chunk = signData[offset:]
 
         if first:
             print("LENGTH DONGLE")
-            totalSize = len(donglePath) + 1 + len(chunk)
+            totalSize = len(pathHeader) + len(chunk)
             print(binascii.hexlify(chunk))
-            apdu = "D4040000".decode('hex') + chr(totalSize) + chr(pathSize) + donglePath + chunk
+            apdu = ("D40400" + p2).decode('hex') + chr(totalSize) + pathHeader + chunk
             first = False
         else:
             totalSize = len(chunk)
@@ -83,4 +155,5 @@ with file(args.file) as f:
         result = dongle.exchange(bytes(apdu))
         # print binascii.hexlify(result)
 
-print(binascii.hexlify(result))
+for i in range(0, len(result), 65):
+    print(binascii.hexlify(result[i: i + 65]))